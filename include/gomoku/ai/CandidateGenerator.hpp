@@ -6,7 +6,7 @@
 #include <cstdint>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 struct CandidateConfig {
     uint8_t groupGap = 1; // distance Chebyshev pour grouper les îlots
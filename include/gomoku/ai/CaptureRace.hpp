@@ -0,0 +1,82 @@
+#pragma once
+#include "gomoku/core/Types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+class Board;
+
+struct CaptureRaceConfig {
+    int pairsThreshold = 3; // oracle actif dès qu'un camp a capturé ce nombre de paires
+    int maxDepth = 6; // coups d'attaque max (captures, menaces de capture, quatres)
+    long long nodeLimit = 600; // nœuds max par décision
+    std::size_t cacheEntries = 1u << 16; // verdicts par clé Zobrist (puissance de 2)
+};
+
+// Capture-race solver for late-game positions where a side is close to captureWinPairs.
+// The attacker only plays captures, moves that threaten a capture (X O O _) and fours; a
+// move counts only if it leaves a win next move. The defender then tries every move that
+// can stop it: the threatened cells, each capture of its own (capture::wouldCapture), its
+// own fives, and against a five the moves that make it breakable (a stone next to one of its
+// pairs, a capture threat anywhere). Any other reply leaves the threat standing, so a Win
+// or Loss is exact; everything else is Unknown.
+class CaptureRace {
+public:
+    enum class Verdict : uint8_t { Unknown, Win, Loss }; // pour le camp au trait
+
+    struct Result {
+        Verdict verdict = Verdict::Unknown;
+        int plies = 0; // demi-coups jusqu'au coup gagnant inclus (1 = gain immédiat)
+    };
+
+    explicit CaptureRace(const CaptureRaceConfig& cfg = {})
+        : cfg_(cfg)
+    {
+    }
+
+    // Close enough to captureWinPairs for the oracle to be worth its nodes
+    bool applies(const Board& board, const RuleSet& rules) const noexcept;
+
+    // Exact result of the race for the side to move, cached by Zobrist key. An aborted
+    // decision (stop flag, or 'nodeLimit' below the config's: the caller's node budget) is
+    // not cached. 'board' is restored.
+    Result decide(Board& board, const RuleSet& rules, const std::atomic<bool>* stop = nullptr, long long nodeLimit = 0);
+
+    long long nodes() const noexcept { return totalNodes_; }
+    const CaptureRaceConfig& config() const noexcept { return cfg_; }
+
+private:
+    enum class Outcome : uint8_t { Win, NoWin, Aborted };
+
+    // Side to move attacks: wins now, or makes a threat every defence of which loses
+    Outcome attack(Board& board, int depth, int& plies);
+    // Side to move defends against the threats of the opponent
+    Outcome defend(Board& board, int depth, int& plies);
+
+    // Moves of the side to move that win at once
+    std::vector<Move> immediateWins(Board& board) const;
+    // Winning moves the opponent would have if it were its turn
+    std::vector<Move> threatsAgainst(Board& board) const;
+    bool enterNode();
+
+    struct CacheEntry {
+        uint64_t key = 0;
+        Verdict verdict = Verdict::Unknown;
+        uint8_t plies = 0;
+    };
+
+    CaptureRaceConfig cfg_;
+    std::vector<CacheEntry> cache_; // alloué au premier appel
+    long long totalNodes_ { 0 };
+
+    // State of the running decide()
+    const RuleSet* rules_ { nullptr };
+    const std::atomic<bool>* stop_ { nullptr };
+    long long nodes_ { 0 };
+    long long limit_ { 0 };
+    bool aborted_ { false };
+};
+
+} // namespace gomoku
@@ -1,11 +1,14 @@
 #pragma once
 #include "gomoku/core/Types.hpp"
+#include <memory>
+#include <string>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 class Board;
 }
 
-namespace gomoku::eval {
+namespace gomoku::inline GOMOKU_SIZE_NS::eval {
+class NnueNetwork;
 
 struct EvalConfig {
     int capturePairValue = 8000;
@@ -35,23 +38,28 @@ struct EvalConfig {
     // Capture potential
     int captureSetupBonus = 400;
     int captureSetupPenalty = 600;
+
+    // Quantized network (NnueNetwork): with useNnue and a readable nnueFile, evaluate() is
+    // the network's score; otherwise the pattern evaluation above
+    bool useNnue = false;
+    std::string nnueFile;
 };
 
 class Evaluator {
 public:
-    explicit Evaluator(const EvalConfig& cfg = {})
-        : cfg_(cfg)
-    {
-    }
+    explicit Evaluator(const EvalConfig& cfg = {});
 
     // Évaluation statique rapide d'une position (Gomoku)
     int evaluate(const Board& board, Player perspective) const noexcept;
 
-    void setConfig(const EvalConfig& cfg) { cfg_ = cfg; }
+    void setConfig(const EvalConfig& cfg);
     const EvalConfig& getConfig() const { return cfg_; }
+    // The network is in use (useNnue and nnueFile loaded)
+    bool usesNnue() const noexcept { return nnue_ != nullptr; }
 
 private:
     EvalConfig cfg_;
+    std::shared_ptr<const NnueNetwork> nnue_; // partagé par les évaluateurs du même fichier
 };
 
 } // namespace gomoku::eval
\ No newline at end of file
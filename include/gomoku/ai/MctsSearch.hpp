@@ -0,0 +1,167 @@
+#pragma once
+#include "gomoku/ai/CandidateGenerator.hpp"
+#include "gomoku/ai/Evaluator.hpp"
+#include "gomoku/ai/SearchStats.hpp"
+#include "gomoku/ai/TimeManager.hpp"
+#include "gomoku/core/Types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+class Board;
+
+struct MctsConfig {
+    int timeBudgetMs = 500; // Budget temps (ms) par coup
+    // Mode budget (> 0) : seul ce nombre de playouts (tous threads) arrête la recherche
+    unsigned long long playoutBudget = 0;
+    int threads = 1; // parallélisme d'arbre : threads partageant le même arbre
+    std::size_t arenaBytes = (64ull << 20); // arène de nœuds : plein = les feuilles ne sont plus développées
+    int maxDepth = 60; // au-delà : feuille évaluée sans développement
+
+    // Time management (TimeManager), opt-in as in SearchConfig: the root is checked every
+    // optimumMs / 8 as an iteration; off, every search uses its whole budget
+    bool adaptiveTime = false;
+    int softTimePercent = 50;
+    GameClock clock {};
+
+    // PUCT: Q + cpuct * P * sqrt(N parent) / (1 + N)
+    float cpuct = 1.5f;
+    float fpuReduction = 0.3f; // Q d'un fils jamais visité = Q du parent - fpuReduction
+    int virtualLoss = 3; // défaites fictives d'un chemin en cours de descente
+    // Evaluator scores: leaf value tanh(score / valueScale), priors softmax(score / priorTemperature)
+    float valueScale = 4000.f;
+    float priorTemperature = 1500.f;
+    // Expansion: CandidateGenerator moves, the best maxChildren by score after the move
+    CandidateConfig expansion { 1, 1, 2, 128, true };
+    int maxChildren = 24;
+};
+
+// Monte Carlo tree search with PUCT selection.
+// - Nodes live in a fixed arena: a node's children are one contiguous block taken with a
+//   single atomic bump, so expansion never locks and the tree is dropped by resetting the index.
+// - Tree parallelism: every thread descends the same tree on its own board copy; a path being
+//   descended carries virtual losses so that the other threads spread over other moves.
+// - No rollouts: a new leaf gets the Evaluator score of its position, and its children the
+//   scores of the positions after each candidate as priors. A move that wins at once replaces
+//   the other children and is a terminal node of exact value.
+class MctsSearch {
+public:
+    explicit MctsSearch(const MctsConfig& conf = {}, const eval::EvalConfig& evalConf = {});
+    ~MctsSearch();
+    MctsSearch(const MctsSearch&) = delete;
+    MctsSearch& operator=(const MctsSearch&) = delete;
+
+    // Most visited root move; stats->nodes counts the playouts
+    std::optional<Move> bestMove(Board& board, const RuleSet& rules, SearchStats* stats);
+
+    // Thread-safe: the running search (or ponder) stops after its current playouts. With no
+    // search running, the next bestMove() / ponder is stopped: the flag is consumed at its end.
+    void stop() noexcept { stopRequested_.store(true, std::memory_order_relaxed); }
+
+    // Pondering, as in MinimaxSearch: the tree grows on the opponent's time and ponderHit()
+    // gives it a deadline
+    void startPonder(const Board& board, const RuleSet& rules);
+    std::optional<Move> ponderHit(int timeMs, SearchStats* stats);
+    void stopPonder();
+    bool isPondering() const noexcept { return ponder_ != nullptr; }
+
+    // Configuration helpers used by MctsSearchEngine
+    void setTimeBudgetMs(int ms)
+    {
+        stopPonder();
+        cfg_.timeBudgetMs = ms;
+    }
+    void setMaxDepth(int d)
+    {
+        stopPonder();
+        cfg_.maxDepth = d < 1 ? 1 : d;
+    }
+    void setPlayoutBudget(unsigned long long playouts)
+    {
+        stopPonder();
+        cfg_.playoutBudget = playouts;
+    }
+    void setGameClock(const GameClock& c)
+    {
+        stopPonder();
+        cfg_.clock = c;
+    }
+    void setThreadCount(int n)
+    {
+        stopPonder();
+        cfg_.threads = n < 1 ? 1 : n;
+    }
+    // Frees the arena, allocated again with this size by the next search
+    void setArenaBytes(std::size_t bytes);
+    void clear();
+
+    const MctsConfig& config() const noexcept { return cfg_; }
+    std::size_t arenaCapacity() const noexcept { return capacity_; }
+    // Nodes of the last tree, root included
+    std::size_t treeSize() const noexcept;
+
+    // Analysis helpers
+    int evaluatePublic(const Board& board, Player perspective) const;
+    // Expansion order: candidates by Evaluator score after the move, at most maxChildren
+    std::vector<Move> orderedMovesPublic(const Board& board, const RuleSet& rules) const;
+
+private:
+    enum State : uint8_t { Leaf, Expanding, Expanded, Terminal };
+
+    struct Node {
+        std::atomic<int32_t> visits { 0 }; // playouts terminés + pertes virtuelles en cours
+        std::atomic<int64_t> valueSum { 0 }; // en VALUE_ONE, pour le camp qui a joué 'move'
+        std::atomic<uint8_t> state { Leaf };
+        uint16_t childCount = 0; // publiés par state = Expanded (release)
+        uint32_t firstChild = 0;
+        Move move {};
+        float prior = 0.f;
+        float terminal = 0.f; // valeur exacte d'un nœud Terminal pour le camp qui a joué 'move'
+    };
+    static constexpr int64_t VALUE_ONE = 1 << 16;
+
+    struct Scored {
+        Move move;
+        int score;
+        bool win;
+        bool draw;
+    };
+
+    struct Ponder; // background search state (board copy, movable deadline, thread)
+
+    void allocateArena();
+    // time holds the soft limits; a ponder hit sets them while the search runs
+    std::optional<Move> search(Board& board, const RuleSet& rules, SearchStats* stats, const SearchDeadline& deadline, TimeManager& time);
+    // One selection-expansion-backup pass from the root; false once the search must stop
+    bool playout(Board& board, const RuleSet& rules, std::vector<uint32_t>& path, SearchStats& stats);
+    // Develops 'node' (side to move of 'board'); returns the value of the position for that side
+    float expand(Board& board, const RuleSet& rules, Node& node);
+    uint32_t selectChild(const Node& node) const noexcept;
+    float leafValue(const Board& board) const;
+    std::vector<Scored> scoreMoves(Board& board, const RuleSet& rules) const;
+
+    // Exact win if any, else the most visited child; nullptr if 'node' is not expanded
+    const Node* bestChild(const Node& node) const noexcept;
+    std::vector<Move> principalVariation() const;
+    static double meanValue(const Node& node) noexcept;
+
+    MctsConfig cfg_;
+    eval::Evaluator evaluator_;
+    std::unique_ptr<Node[]> nodes_; // alloué à la première recherche
+    std::size_t capacity_ { 0 };
+    std::atomic<uint32_t> used_ { 0 };
+    std::atomic<bool> arenaFull_ { false };
+    std::unique_ptr<Ponder> ponder_;
+    std::atomic<bool> stopRequested_ { false }; // stop() et stopPonder(), remis à zéro en fin de recherche
+    std::atomic<bool> searchDone_ { false }; // le thread principal a fini : arrêt des helpers
+    std::atomic<unsigned long long> playouts_ { 0 }; // playouts lancés, tous threads
+
+    // State of the running search
+    const SearchDeadline* deadline_ { nullptr };
+};
+
+} // namespace gomoku
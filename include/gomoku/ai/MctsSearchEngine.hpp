@@ -0,0 +1,62 @@
+#pragma once
+#include "gomoku/ai/MctsSearch.hpp"
+#include "gomoku/core/Types.hpp"
+#include "gomoku/interfaces/ISearchEngine.hpp"
+
+namespace gomoku::inline GOMOKU_SIZE_NS::ai {
+
+/**
+ * ISearchEngine backed by Monte Carlo tree search
+ *
+ * Drop-in alternative to MinimaxSearchEngine (GameService::setSearchEngine).
+ * The node budget counts playouts, the table size is the node arena and the
+ * depth limit is the deepest node developed.
+ */
+class MctsSearchEngine : public ISearchEngine {
+public:
+    MctsSearchEngine();
+    explicit MctsSearchEngine(const MctsConfig& config);
+    ~MctsSearchEngine() override = default;
+
+    // Configuration methods
+    void setTimeLimit(int milliseconds) override;
+    void setDepthLimit(int maxDepth) override;
+    void setTranspositionTableSize(size_t bytes) override;
+    void setThreadCount(int threads) override;
+    void setGameClock(const GameClock& clock) override;
+    void setNodeBudget(unsigned long long nodes) override;
+
+    // Search operations
+    std::optional<Move> findBestMove(
+        const IBoardView& board,
+        const RuleSet& rules,
+        SearchStats* stats = nullptr) override;
+
+    std::optional<Move> suggestMove(
+        const IBoardView& board,
+        const RuleSet& rules,
+        int timeMs,
+        SearchStats* stats = nullptr) override;
+
+    void stop() override;
+
+    // Pondering (delegates to MctsSearch::startPonder / ponderHit / stopPonder)
+    void startPondering(const IBoardView& board, const RuleSet& rules) override;
+    std::optional<Move> ponderHit(int timeMs, SearchStats* stats = nullptr) override;
+    void stopPondering() override;
+
+    // Analysis methods
+    int evaluatePosition(const IBoardView& board, Player perspective) const override;
+    std::vector<Move> getOrderedMoves(const IBoardView& board, const RuleSet& rules) const override;
+
+    // Statistics and debugging (the tree is the table: clearing frees the arena)
+    void clearTranspositionTable() override;
+    SearchStats getLastSearchStats() const override;
+
+private:
+    MctsSearch searchImpl_;
+    MctsConfig config_;
+    SearchStats lastStats_;
+};
+
+} // namespace gomoku::ai
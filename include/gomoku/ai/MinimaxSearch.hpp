@@ -1,23 +1,56 @@
 #pragma once
+#include "gomoku/ai/CaptureRace.hpp"
 #include "gomoku/ai/Evaluator.hpp"
 #include "gomoku/ai/MoveOrderer.hpp"
 #include "gomoku/ai/SearchStats.hpp"
+#include "gomoku/ai/ThreatSearch.hpp"
+#include "gomoku/ai/TimeManager.hpp"
+#include "gomoku/ai/TranspositionPool.hpp"
 #include "gomoku/ai/TranspositionTable.hpp"
 #include "gomoku/core/Types.hpp"
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 class Board;
 
 struct SearchConfig {
     int timeBudgetMs = 500; // Budget temps (ms) pour la recherche
     int maxDepthHint = 11; // Profondeur max d'itération - augmentée pour forcer l'efficacité
     std::size_t ttBytes = (128ull << 20); // Taille TT : 128MB (doublée) pour meilleur hit rate
-    unsigned long long nodeCap = 0; // Limite de nœuds dure (0 = désactivée)
+    unsigned long long nodeCap = 0; // Limite de nœuds dure, qsearch compris, en plus du temps (0 = désactivée)
+    // Mode budget de nœuds (> 0) : seul ce nombre de nœuds (qsearch compris, tous threads) arrête
+    // la recherche ; horloge et gestion du temps ignorées, même résultat sur toute machine (1 thread)
+    unsigned long long nodeBudget = 0;
+    int threads = 1; // Lazy SMP : threads de recherche partageant la TT (1 = séquentiel)
+    bool sharedTT = false; // TT du processus (ttpool, budget global) au lieu d'une table privée de ttBytes
+    bool prefaultTT = false; // table privée faultée dès son dimensionnement (TranspositionTable::prefault)
+    std::string ttFile; // TT persistante (table privée) : chargée à la 1re recherche, sauvée par saveTranspositionTable()
+
+    // Time management (TimeManager): timeBudgetMs, or the clock share, is the hard limit.
+    // adaptiveTime (opt-in): iterations stop before it on a settled root and run up to it
+    // when the move is uncertain; off, every search uses its whole budget as before
+    bool adaptiveTime = false;
+    int softTimePercent = 50; // temps visé pour une position normale, en % du hard
+    GameClock clock {}; // pendule du camp au trait (remainingMs > 0 : remplace timeBudgetMs)
+
+    // Threat-space search (ThreatSearch) before iterative deepening: a forced win by fours
+    // (VCF) is played without running the main search; the first move of a win by threes
+    // and fours (VCT) is searched first at the root, the main search checking it
+    bool useThreatSearch = true;
+    ThreatSearchConfig threatSearch {};
+
+    // Capture race (CaptureRace): once a side has captureRace.pairsThreshold pairs, negamax
+    // asks the race solver first and returns its exact win or loss without searching
+    bool useCaptureRace = true;
+    int captureRaceMinDepth = 2; // profondeur restante min (les nœuds frontière s'en passent)
+    CaptureRaceConfig captureRace {};
 
     // Aspiration window parameters
     bool useAspirationWindows = true; // Enable/disable aspiration windows
@@ -33,33 +66,102 @@ struct SearchConfig {
 };
 class MinimaxSearch {
 public:
-    explicit MinimaxSearch(const SearchConfig& conf, const eval::EvalConfig& evalConf = {})
-        : cfg(conf)
-        , evaluator_(evalConf)
-    {
-        tt.resizeBytes(cfg.ttBytes); // Initialize TT with configured size
-    }
+    explicit MinimaxSearch(const SearchConfig& conf, const eval::EvalConfig& evalConf = {});
+    ~MinimaxSearch();
+    MinimaxSearch(const MinimaxSearch&) = delete;
+    MinimaxSearch& operator=(const MinimaxSearch&) = delete;
 
     std::optional<Move> bestMove(Board& board, const RuleSet& rules, SearchStats* stats);
 
+    // Thread-safe: aborts the running search (or ponder) within a clock poll; bestMove()
+    // then returns the best move of the completed part of the search. With no search running
+    // the request is kept and aborts the next bestMove() / ponder: it is consumed when that
+    // search ends.
+    void stop() noexcept { stopRequested_.store(true, std::memory_order_relaxed); }
+
+    // Pondering: searches `board` (the position after the expected reply) on a background
+    // thread with no deadline, with its own orderer, evaluator and solvers over the shared TT
+    // (evaluatePublic / orderedMovesPublic stay usable meanwhile). No other search runs on
+    // this object meanwhile: bestMove() and the setters stop the ponder first.
+    void startPonder(const Board& board, const RuleSet& rules);
+    // The expected reply was played: the running search keeps its TT, killers and depth and
+    // now stops timeMs from here. nullopt if nothing is pondering.
+    std::optional<Move> ponderHit(int timeMs, SearchStats* stats);
+    // Another move was played: the ponder search aborts at once (its TT entries stay).
+    void stopPonder();
+    bool isPondering() const noexcept { return ponder_ != nullptr; }
+
     // Configuration helpers used by MinimaxSearchEngine
-    void setTimeBudgetMs(int ms) { cfg.timeBudgetMs = ms; }
-    void setMaxDepthHint(int d) { cfg.maxDepthHint = d; }
-    void setEvalConfig(const eval::EvalConfig& ec) { evaluator_.setConfig(ec); }
+    void setTimeBudgetMs(int ms)
+    {
+        stopPonder();
+        cfg.timeBudgetMs = ms;
+    }
+    void setMaxDepthHint(int d)
+    {
+        stopPonder();
+        cfg.maxDepthHint = d;
+    }
+    void setNodeBudget(unsigned long long nodes)
+    {
+        stopPonder();
+        cfg.nodeBudget = nodes;
+    }
+    // Read by the next bestMove() / ponderHit(): a running ponder keeps going
+    void setGameClock(const GameClock& c) { cfg.clock = c; }
+    void setThreadCount(int n)
+    {
+        stopPonder();
+        cfg.threads = n < 1 ? 1 : n;
+    }
+    void setEvalConfig(const eval::EvalConfig& ec)
+    {
+        stopPonder();
+        evaluator_.setConfig(ec);
+    }
 
+    // Explicit sizing gives the engine a private table (leaves the shared pool)
     void setTranspositionTableSize(std::size_t bytes)
     {
+        stopPonder();
         cfg.ttBytes = bytes;
-        tt.resizeBytes(bytes);
+        if (cfg.sharedTT) {
+            cfg.sharedTT = false;
+            tt = std::make_shared<TranspositionTable>();
+        }
+        tt->resizeBytes(bytes);
+        if (cfg.prefaultTT)
+            tt->prefault();
     }
 
-    void clearTranspositionTable() { tt.resizeBytes(cfg.ttBytes); }
+    // On the shared table this clears the entries of every session
+    void clearTranspositionTable() { tt->clear(); }
+
+    // Warm starts: the file only matches searches under the same rules (and Zobrist keys).
+    // Loading is refused on the shared table, whose size belongs to the pool budget.
+    bool saveTranspositionTable(const std::string& path, const RuleSet& rules) const;
+    bool loadTranspositionTable(const std::string& path, const RuleSet& rules);
+    // Writes cfg.ttFile for the rules it was loaded under (false before the first search).
+    // Explicit and synchronous (the whole table is written): call it at a shutdown point of
+    // the caller's choosing, destruction never writes the file.
+    bool saveTranspositionTable() const;
 
     // Lightweight public helpers for tooling/analysis
     int evaluatePublic(const Board& board, Player perspective) const;
     std::vector<Move> orderedMovesPublic(const Board& board, const RuleSet& rules, Player toPlay) const;
 
 private:
+    // Lazy SMP helper: own orderer (killers/history) and evaluator, TT shared with the main search
+    MinimaxSearch(const SearchConfig& conf, const eval::EvalConfig& evalConf, std::shared_ptr<TranspositionTable> sharedTT);
+
+    struct Ponder; // background search state (board copy, movable deadline, thread)
+
+    // Body of bestMove(): runs until deadline, or until *stop_ is raised. time holds the soft
+    // limits matching deadline (used when cfg.adaptiveTime).
+    std::optional<Move> search(Board& board, const RuleSet& rules, SearchStats* stats, const SearchDeadline& deadline, TimeManager& time);
+    // cfg.ttFile into the table, once, under the rules of the first search
+    void loadTranspositionFile(const RuleSet& rules);
+
     // --- Core search primitives (signatures only) ---
 
     // Negamax with alpha-beta pruning and PVS. Returns best score and fills PV.
@@ -81,6 +183,11 @@ private:
     // fills best, bestScore, pv and updates nodes.
     bool runDepthWithWindow(int depth, Board& board, const RuleSet& rules, Player toPlay, const std::vector<Move>& rootCandidates, std::optional<Move>& best, int& bestScore, std::vector<Move>& pv, const SearchContext& ctx, int alpha, int beta);
 
+    // Iterative deepening with aspiration windows from startDepth to cfg.maxDepthHint.
+    // Keeps the last usable result in best/pv; returns the last depth attempted.
+    // time (main thread only) may stop between iterations, before the hard deadline.
+    int deepen(Board& board, const RuleSet& rules, Player toPlay, const std::vector<Move>& rootCandidates, int startDepth, std::optional<Move>& best, std::vector<Move>& pv, const SearchContext& ctx, std::chrono::steady_clock::time_point start, TimeManager* time = nullptr);
+
     // Legacy wrapper for backwards compatibility (uses full window)
     bool runDepth(int depth, Board& board, const RuleSet& rules, Player toPlay, const std::vector<Move>& rootCandidates, std::optional<Move>& best, int& bestScore, std::vector<Move>& pv, const SearchContext& ctx)
     {
@@ -89,9 +196,18 @@ private:
     }
 
     SearchConfig cfg {};
-    TranspositionTable tt;
+    std::shared_ptr<TranspositionTable> tt; // partagée avec les helpers Lazy SMP
+    std::optional<RuleSet> ttFileRules_; // règles de cfg.ttFile, fixées à la 1re recherche
+    std::unique_ptr<Ponder> ponder_;
+    double rootBestNodeShare_ = 0.0; // part des nœuds racine du meilleur coup (dernière itération)
+    std::atomic<bool> stopRequested_ { false }; // stop() et stopPonder(), remis à zéro en fin de recherche
+    std::atomic<bool>* stop_ { &stopRequested_ }; // lu par search() : celui du propriétaire pour la réflexion
+    uint32_t pollInterval_ = 256; // nœuds entre deux lectures de l'horloge, recalibré sur le NPS mesuré
     MoveOrderer orderer_ { MoveOrdererConfig {} };
     eval::Evaluator evaluator_;
+    ThreatSearch threats_; // racine seulement (cache d'échecs conservé entre les coups)
+    CaptureRace race_; // oracle de negamax, propre à chaque thread (verdicts conservés entre les coups)
+    std::optional<Move> rootHint_; // 1er coup du VCT trouvé à la racine, examiné en premier
 };
 
 } // namespace gomoku
@@ -3,7 +3,7 @@
 #include "gomoku/core/Types.hpp"
 #include "gomoku/interfaces/ISearchEngine.hpp"
 
-namespace gomoku::ai {
+namespace gomoku::inline GOMOKU_SIZE_NS::ai {
 
 /**
  * Concrete implementation of ISearchEngine using minimax search
@@ -15,12 +15,17 @@ class MinimaxSearchEngine : public ISearchEngine {
 public:
     MinimaxSearchEngine();
     explicit MinimaxSearchEngine(const SearchConfig& config);
+    // evalConfig.useNnue selects the network evaluator
+    MinimaxSearchEngine(const SearchConfig& config, const eval::EvalConfig& evalConfig);
     ~MinimaxSearchEngine() override = default;
 
     // Configuration methods
     void setTimeLimit(int milliseconds) override;
     void setDepthLimit(int maxDepth) override;
     void setTranspositionTableSize(size_t bytes) override;
+    void setThreadCount(int threads) override;
+    void setGameClock(const GameClock& clock) override;
+    void setNodeBudget(unsigned long long nodes) override;
 
     // MinimaxSearch operations
     std::optional<Move> findBestMove(
@@ -34,6 +39,13 @@ public:
         int timeMs,
         SearchStats* stats = nullptr) override;
 
+    void stop() override;
+
+    // Pondering (delegates to MinimaxSearch::startPonder / ponderHit / stopPonder)
+    void startPondering(const IBoardView& board, const RuleSet& rules) override;
+    std::optional<Move> ponderHit(int timeMs, SearchStats* stats = nullptr) override;
+    void stopPondering() override;
+
     // Analysis methods
     int evaluatePosition(const IBoardView& board, Player perspective) const override;
     std::vector<Move> getOrderedMoves(const IBoardView& board, const RuleSet& rules) const override;
@@ -6,7 +6,7 @@
 #include <optional>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 struct MoveOrdererConfig {
     // Caps augmentés drastiquement pour explorer tous les coups prometteurs
     int capDeepRoot = 40; // depth >= 8 - augmenté de 30 à 40
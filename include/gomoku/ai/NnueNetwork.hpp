@@ -0,0 +1,70 @@
+#pragma once
+#include "gomoku/core/Types.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+class Board;
+}
+
+namespace gomoku::inline GOMOKU_SIZE_NS::eval {
+
+// Raw parameters of an NnueNetwork, as stored in its binary file
+struct NnueWeights {
+    static constexpr int HIDDEN = 128; // accumulateurs int16 par perspective
+    static constexpr int MAX_PAIRS = 7; // compteur de paires saturé au-delà
+    static constexpr int CELLS = BOARD_SIZE * BOARD_SIZE;
+    // Per perspective: own stones, opponent stones, own pair count, opponent pair count (one-hot)
+    static constexpr int INPUTS = 2 * CELLS + 2 * (MAX_PAIRS + 1);
+
+    std::vector<int16_t> featureWeights; // INPUTS x HIDDEN, ligne par entrée
+    std::vector<int16_t> featureBias; // HIDDEN
+    std::vector<int8_t> outputWeights; // 2 x HIDDEN : camp au trait, puis adversaire
+    int32_t outputBias = 0;
+    int32_t outputScale = 1 << 16; // 16.16 : (somme + outputBias) -> unités de l'Evaluator
+
+    // All-zero network of the right shape
+    static NnueWeights zero();
+    bool valid() const noexcept;
+
+    // Little-endian file: header (magic, version, board size, HIDDEN, MAX_PAIRS, outputBias,
+    // outputScale), then featureBias, featureWeights and outputWeights
+    bool save(const std::string& path) const;
+    // nullopt on a missing or truncated file, or one made for another board size or shape
+    static std::optional<NnueWeights> load(const std::string& path);
+};
+
+// Quantized evaluation network with incrementally updated accumulators ("NNUE").
+// - Input layer: one int16 accumulator of HIDDEN values per perspective, the sum of the
+//   weight rows of the features present (stones relative to that side, captured pairs).
+// - Output: clipped ReLU [0, 127] of both accumulators, side to move first, dot product
+//   with int8 weights. AVX2 or SSE4.1 kernels are picked at run time, scalar code elsewhere.
+// - Accumulators are kept per thread along the board's undo stack: evaluate() finds the
+//   deepest position of the stack it already knows (by Zobrist key) and replays the moves
+//   after it, adding the placed stone and removing the captured ones. A board it does not
+//   know is refreshed from scratch.
+class NnueNetwork {
+public:
+    explicit NnueNetwork(NnueWeights weights);
+
+    // Shared network for a file, read once while any evaluator holds it; nullptr if unusable
+    static std::shared_ptr<const NnueNetwork> open(const std::string& path);
+
+    // Score for 'perspective', in Evaluator units
+    int evaluate(const Board& board, Player perspective) const noexcept;
+    // Same score computed from scratch with the scalar code (reference)
+    int evaluateFull(const Board& board, Player perspective) const noexcept;
+
+    const NnueWeights& weights() const noexcept { return w_; }
+    // Kernels used by evaluate(): "avx2", "sse4.1" or "scalar"
+    static const char* simdName() noexcept;
+
+private:
+    NnueWeights w_;
+    uint64_t id_; // identifie le réseau dans les accumulateurs des threads
+};
+
+} // namespace gomoku::eval
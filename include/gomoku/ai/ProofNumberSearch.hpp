@@ -0,0 +1,101 @@
+#pragma once
+#include "gomoku/ai/CandidateGenerator.hpp"
+#include "gomoku/ai/SearchStats.hpp"
+#include "gomoku/core/Types.hpp"
+#include "gomoku/interfaces/ISolver.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+class Board;
+
+struct ProofSearchConfig {
+    std::size_t tableBytes = 32ull << 20; // table de preuve (arrondie à une puissance de 2 de buckets)
+    unsigned long long nodeLimit = 1'000'000; // 0 = illimité
+    int timeLimitMs = 0; // 0 = illimité
+    int maxPly = 40; // au-delà : compté comme non prouvé
+    // Coups de l'attaquant : n'importe quel sous-ensemble laisse une preuve valide
+    CandidateConfig attackMoves { 1, 1, 1, 24, true };
+    // Parades : anneau Manhattan 4 (tout le carré de 2) autour de toutes les pierres, pour ne
+    // pas écarter un quatre adverse
+    CandidateConfig defenceMoves { 1, 2, 4, 512, true };
+};
+
+// Depth-first proof-number search (df-pn) with the 1+epsilon threshold trick.
+// - OR nodes: the attacker to move, proven when one child is; AND nodes: the defender to
+//   move, proven when all children are.
+// - Moves come from CandidateGenerator and are played with Board::makeMove/unmakeMove, so
+//   a game ends on an unbreakable five or on captureWinPairs, whoever reaches it.
+// - Proof and disproof numbers live in a fixed-size table keyed by Zobrist, reset for each
+//   call; captured pairs only grow, so positions never repeat and the graph has no cycles.
+// A proof holds against every defence within the defence ring. Disproofs only mean "no win
+// with the attacker's candidates within maxPly" and are never reported as a loss.
+class ProofNumberSearch : public ISolver {
+public:
+    explicit ProofNumberSearch(const ProofSearchConfig& cfg = {});
+
+    // ISolver: Win if the side to move forces a win, Loss if the opponent does
+    void setNodeLimit(unsigned long long nodes) override { cfg_.nodeLimit = nodes; }
+    void setTimeLimit(int milliseconds) override { cfg_.timeLimitMs = milliseconds; }
+    void setMemoryLimit(std::size_t bytes) override;
+    ProofResult solve(const IBoardView& board, const RuleSet& rules) override;
+    void stop() override { stopRequested_.store(true, std::memory_order_relaxed); }
+    void clear() override;
+
+    // Does 'attacker' force a win? Win/Loss are then relative to the side to move of 'board',
+    // Unknown when not proven. 'board' is restored.
+    ProofResult prove(Board& board, const RuleSet& rules, Player attacker);
+
+    const ProofSearchConfig& config() const noexcept { return cfg_; }
+    std::size_t tableEntries() const noexcept { return table_.size(); }
+
+private:
+    static constexpr uint32_t PN_INF = 0x3fffffffu;
+
+    struct Entry {
+        uint64_t key;
+        uint32_t pn;
+        uint32_t dn;
+        uint32_t work; // nœuds du sous-arbre, critère de remplacement
+        uint16_t best; // case du coup prouvant (OR) ou de la parade la plus coûteuse (AND)
+        uint8_t generation; // entrées des appels précédents = libres
+    };
+    static constexpr int BUCKET = 4;
+
+    struct Bounds {
+        uint32_t pn;
+        uint32_t dn;
+    };
+
+    // One df-pn run from the root, within 'nodeLimit' (0 = none) and the deadline set by the caller
+    ProofResult run(Board& board, const RuleSet& rules, Player attacker, unsigned long long nodeLimit);
+    // Multiple iterative deepening on one node: returns once pn >= thPn or dn >= thDn
+    Bounds mid(Board& board, uint64_t key, uint32_t thPn, uint32_t thDn, int ply);
+    // Attacker's or defender's candidates, tactical moves first
+    std::vector<Move> children(const Board& board, bool orNode) const;
+    bool enterNode();
+
+    uint64_t nodeKey(const Board& board) const noexcept;
+    const Entry* lookup(uint64_t key) const noexcept;
+    void store(uint64_t key, Bounds b, uint32_t work, uint16_t best) noexcept;
+    // Winner's line from the root, re-proving nodes evicted from the table
+    void extractLine(Board& board, std::vector<Move>& line);
+
+    ProofSearchConfig cfg_;
+    std::vector<Entry> table_; // BUCKET entrées par bucket
+    std::atomic<bool> stopRequested_ { false };
+
+    // State of the running prove()
+    const RuleSet* rules_ { nullptr };
+    Player attacker_ { Player::Black };
+    SearchDeadline deadline_ { SearchDeadline::clock::time_point::max() };
+    bool timed_ { false };
+    unsigned long long nodeLimit_ { 0 };
+    uint8_t generation_ { 0 };
+    long long nodes_ { 0 };
+    bool aborted_ { false };
+};
+
+} // namespace gomoku
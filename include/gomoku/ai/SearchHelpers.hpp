@@ -3,11 +3,11 @@
 #include "gomoku/core/Types.hpp"
 #include <optional>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 class Board;
 }
 
-namespace gomoku::search {
+namespace gomoku::inline GOMOKU_SIZE_NS::search {
 
 // Constants for search scoring
 constexpr int INF = 1'000'000; // Generic infinity bound for alpha-beta
@@ -18,14 +18,21 @@ constexpr int MATE_SCORE = 900'000; // Base score for mate-like terminal outcome
 // Returns true if terminal, false otherwise. Sets outScore to the evaluation from current player's perspective.
 bool isTerminal(const Board& board, int ply, int& outScore) noexcept;
 
+// Clé TT d'une position : Zobrist du plateau combiné au jeu de règles, pour qu'une table
+// partagée entre sessions (TranspositionPool) ne confonde pas des parties aux règles différentes.
+uint64_t ttKey(const Board& board, const RuleSet& rules) noexcept;
+
+// Empreinte d'un fichier TT : règles et clés Zobrist avec lesquelles ses entrées ont été calculées.
+uint64_t ttFingerprint(const RuleSet& rules) noexcept;
+
 // Interroge la TT: si une entrée suffisante existe, fournit un bound et/ou un coup d'appoint.
 // Returns true if a usable bound/cutoff is found, false otherwise.
 // Always provides ttMove for move ordering if available (even when returning false).
-bool ttProbe(const TranspositionTable& tt, const Board& board, int depth, int alpha, int beta, int& outScore, std::optional<Move>& ttMove, TranspositionTable::Flag& outFlag) noexcept;
+bool ttProbe(const TranspositionTable& tt, const Board& board, const RuleSet& rules, int depth, int alpha, int beta, int& outScore, std::optional<Move>& ttMove, TranspositionTable::Flag& outFlag) noexcept;
 
 // Stocke un résultat dans la TT (clé, profondeur, score, flag, meilleur coup).
 // Relies on TT's internal replacement policy (prefer deeper entries).
-void ttStore(TranspositionTable& tt, const Board& board, int depth, int score, TranspositionTable::Flag flag, const std::optional<Move>& best) noexcept;
+void ttStore(TranspositionTable& tt, const Board& board, const RuleSet& rules, int depth, int score, TranspositionTable::Flag flag, const std::optional<Move>& best) noexcept;
 
 // Tries to find an immediate winning move from the given candidates.
 // Only checks if plausible (≥4 stones for alignment win, ≥4 captured pairs for capture win).
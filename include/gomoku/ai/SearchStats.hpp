@@ -1,31 +1,66 @@
 #pragma once
 #include "gomoku/core/Types.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 // Forward declaration
 struct SearchStats;
 
+// Search deadline that another thread may move while the search runs
+// (pondering: no deadline until the expected move is played, then the normal budget)
+class SearchDeadline {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit SearchDeadline(clock::time_point t) noexcept
+        : ticks_(t.time_since_epoch().count())
+    {
+    }
+
+    void set(clock::time_point t) noexcept { ticks_.store(t.time_since_epoch().count(), std::memory_order_relaxed); }
+    clock::time_point get() const noexcept { return clock::time_point(clock::duration(ticks_.load(std::memory_order_relaxed))); }
+    bool passed(clock::time_point now) const noexcept { return now.time_since_epoch().count() >= ticks_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<clock::rep> ticks_;
+};
+
 // Context passed through recursive search to avoid long parameter lists
 // Provides fluent API for incrementing counters and checking time
 struct SearchContext {
     const RuleSet& rules;
-    std::chrono::steady_clock::time_point deadline;
+    const SearchDeadline& deadline;
     SearchStats* stats { nullptr };
-    unsigned long long nodeCap { 0 };
+    unsigned long long nodeCap { 0 }; // this thread's share of the node budget, qsearch included (0 = none)
+    const std::atomic<bool>* stop { nullptr }; // arrêt coopératif : stop() externe, fin des helpers Lazy SMP
+    uint32_t pollInterval { 256 }; // nodes between two reads of the clock and of stop
+
+    // Per-thread state (each search thread owns its context). nodesVisited is counted whether
+    // or not stats are collected, so the node cap does not depend on them.
+    mutable unsigned long long nodesVisited { 0 };
+    mutable uint32_t pollCountdown { 0 };
+    mutable bool aborted { false };
 
     // Fluent API for incrementing counters during search
     inline void recordNode() const;
     inline void recordQNode() const;
     inline void recordTTHit() const;
+    // Nodes of a solver run inside the search (capture race): charged to the node cap only
+    void chargeNodes(unsigned long long n) const noexcept { nodesVisited += n; }
+    // Node cap left to this thread (0 = no cap)
+    unsigned long long nodesLeft() const noexcept { return nodeCap > nodesVisited ? nodeCap - nodesVisited : 0; }
 
-    // Time management
-    inline bool isTimeUp() const
-    {
-        return std::chrono::steady_clock::now() >= deadline;
-    }
+    // Time management: the node cap is exact, the clock and the stop flag are read once every
+    // pollInterval nodes. Once true it stays true: the search unwinds without using the
+    // scores of the aborted subtrees.
+    inline bool isTimeUp() const;
+    // Abort already detected (no polling)
+    bool stopped() const noexcept { return aborted; }
 };
 
 // Statistics collected during and after a search
@@ -37,6 +72,10 @@ struct SearchStats {
     long long qnodes = 0;
     int ttHits = 0;
     int maxDepth = 0; // Real max depth reached (including qsearch)
+    long long nodeBudgetOverrun = 0; // all nodes (solvers included) beyond the node budget, 0 if within
+    long long threatNodes = 0; // nodes of the threat-space solver (VCF/VCT), not in nodes; charged to the budget
+    long long raceNodes = 0; // nodes of the capture-race oracle, not in nodes; charged to the budget
+    int raceProofs = 0; // subtrees replaced by an exact capture-race verdict
 
     // Metadata set at end of iteration (via finalize())
     int depthReached = 0;
@@ -49,11 +88,27 @@ struct SearchStats {
         nodes = 0;
         qnodes = 0;
         ttHits = 0;
+        nodeBudgetOverrun = 0;
+        threatNodes = 0;
+        raceNodes = 0;
+        raceProofs = 0;
         depthReached = 0;
         timeMs = 0;
         principalVariation.clear();
     }
 
+    // Adds the counters of another search thread (Lazy SMP helpers); metadata is left untouched
+    void mergeCounters(const SearchStats& other)
+    {
+        nodes += other.nodes;
+        qnodes += other.qnodes;
+        ttHits += other.ttHits;
+        threatNodes += other.threatNodes;
+        raceNodes += other.raceNodes;
+        raceProofs += other.raceProofs;
+        maxDepth = std::max(maxDepth, other.maxDepth);
+    }
+
     // Finalize metadata after completing an iteration
     // Does NOT touch counters (nodes/qnodes/ttHits) - they are already accurate
     void finalize(std::chrono::steady_clock::time_point startTime,
@@ -102,8 +157,33 @@ inline void recordTTHit(SearchStats* stats)
 }
 
 // SearchContext fluent API implementations
-inline void SearchContext::recordNode() const { recordNodeVisit(stats); }
-inline void SearchContext::recordQNode() const { recordQNodeVisit(stats); }
+inline void SearchContext::recordNode() const
+{
+    recordNodeVisit(stats);
+    ++nodesVisited;
+    if (pollCountdown > 0)
+        --pollCountdown;
+}
+inline void SearchContext::recordQNode() const
+{
+    recordQNodeVisit(stats);
+    ++nodesVisited;
+    if (pollCountdown > 0)
+        --pollCountdown;
+}
 inline void SearchContext::recordTTHit() const { gomoku::recordTTHit(stats); }
 
+inline bool SearchContext::isTimeUp() const
+{
+    if (aborted)
+        return true;
+    if (nodeCap > 0 && nodesVisited >= nodeCap)
+        return aborted = true;
+    if (pollCountdown > 0)
+        return false;
+    pollCountdown = pollInterval;
+    aborted = (stop && stop->load(std::memory_order_relaxed)) || deadline.passed(std::chrono::steady_clock::now());
+    return aborted;
+}
+
 } // namespace gomoku
@@ -0,0 +1,89 @@
+#pragma once
+#include "gomoku/ai/SearchStats.hpp"
+#include "gomoku/core/Types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+class Board;
+
+struct ThreatSearchConfig {
+    int vcfDepth = 16; // coups d'attaque max d'une suite de quatres (VCF)
+    int vctDepth = 5; // coups d'attaque max d'une suite de trois ouverts et de quatres (VCT)
+    long long nodeLimit = 20'000; // nœuds max par résolution (attaques et parades)
+    std::size_t cacheEntries = 1u << 15; // échecs prouvés (puissance de 2), conservés entre appels
+};
+
+struct ThreatResult {
+    bool win = false;
+    std::vector<Move> line; // attaque, parade la plus tenace, attaque... jusqu'au coup gagnant
+    long long nodes = 0;
+};
+
+// Threat-space solver: looks for a forced win of the side to move made only of threats.
+// - VCF (victory by continuous fours): every attacking move makes a four; the defender
+//   must block it, capture one of its stones, or win at once.
+// - VCT (victory by continuous threats): open threes are allowed too; the defender may
+//   also answer a three with a four of its own, which the attacker has to block with a
+//   threat.
+// Captures are part of the defence: a four only counts if the five it completes cannot be
+// broken by a capture, and the moves that would make it breakable are tried as parades.
+// Attacking moves and parades are played with Board::makeMove, so every rule (double-three,
+// must-break, capture win) applies. A search that hits the node limit, the deadline or the
+// stop flag reports no win. 'nodeLimit' (0 = config) lowers the node limit of one call, for
+// a caller that charges the solver to its own node budget.
+class ThreatSearch {
+public:
+    enum class Mode : uint8_t { VCF, VCT };
+
+    explicit ThreatSearch(const ThreatSearchConfig& cfg = {})
+        : cfg_(cfg)
+    {
+    }
+
+    ThreatResult solve(Board& board, const RuleSet& rules, Mode mode,
+        const SearchDeadline* deadline = nullptr, const std::atomic<bool>* stop = nullptr, long long nodeLimit = 0);
+
+    const ThreatSearchConfig& config() const noexcept { return cfg_; }
+
+private:
+    enum class Outcome : uint8_t { Win, NoWin, Aborted };
+
+    struct Threat {
+        Move move;
+        int priority;
+    };
+
+    // Attacker to move: immediate win, else a threat every parade of which still loses.
+    // depth = attacking moves left.
+    Outcome attack(Board& board, int depth, std::vector<Move>& line);
+    // Defender to move, line.back() being the threat just played.
+    Outcome defend(Board& board, int depth, std::vector<Move>& line);
+
+    // Attacker's fours (and open threes in VCT), strongest first
+    std::vector<Threat> threats(const Board& board) const;
+    // Counts a node; false once the node limit, the deadline or the stop flag is reached
+    bool enterNode();
+
+    uint64_t cacheKey(const Board& board) const noexcept;
+    bool cachedFailure(uint64_t key, int depth) const noexcept;
+    void storeFailure(uint64_t key, int depth);
+
+    ThreatSearchConfig cfg_;
+    std::vector<uint64_t> cacheKeys_; // alloué au premier appel
+    std::vector<int8_t> cacheDepth_;
+
+    // State of the running solve()
+    const RuleSet* rules_ { nullptr };
+    Mode mode_ { Mode::VCF };
+    Player attacker_ { Player::Black };
+    const SearchDeadline* deadline_ { nullptr };
+    const std::atomic<bool>* stop_ { nullptr };
+    long long nodes_ { 0 };
+    long long limit_ { 0 };
+    bool aborted_ { false };
+};
+
+} // namespace gomoku
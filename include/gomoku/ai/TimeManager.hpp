@@ -0,0 +1,71 @@
+#pragma once
+#include "gomoku/ai/SearchStats.hpp"
+#include "gomoku/core/Types.hpp"
+#include <atomic>
+#include <chrono>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+// Per-game clock of the side to move. remainingMs == 0: no clock, each move gets
+// SearchConfig::timeBudgetMs.
+struct GameClock {
+    int remainingMs = 0;
+    int incrementMs = 0; // added after each move
+    int movesToGo = 0; // moves until the next time control (0 = whole game)
+};
+
+// Soft/hard time limits for one search.
+// The hard limit is the SearchDeadline polled inside the tree. The soft limit is checked
+// between iterations: optimumMs scaled by how settled the root is. A best move that is
+// stable over several iterations, or that takes most of the root nodes, shrinks it.
+// A best-move flip or a score drop grows it, up to the hard limit.
+class TimeManager {
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Limits {
+        int optimumMs = 0; // target for a normal position
+        int hardMs = 0; // never exceeded
+    };
+
+    // Budget of one move: timeBudgetMs is the hard limit unless a clock is running, in which
+    // case the move gets its share of the remaining time plus most of the increment.
+    static Limits allocate(int timeBudgetMs, const GameClock& gameClock, int softPercent) noexcept;
+
+    // The search window starts hardMs before the deadline: a pondering search (deadline at
+    // infinity) never stops softly, and after a ponder hit the window starts at the hit.
+    TimeManager(const Limits& limits, const SearchDeadline& deadline) noexcept
+        : optimumMs_(limits.optimumMs)
+        , hardMs_(limits.hardMs)
+        , deadline_(deadline)
+    {
+    }
+
+    // Thread-safe: limits of a ponder hit, set before the deadline is moved to the hit's
+    void setLimits(const Limits& limits) noexcept
+    {
+        optimumMs_.store(limits.optimumMs, std::memory_order_relaxed);
+        hardMs_.store(limits.hardMs, std::memory_order_relaxed);
+    }
+
+    // Records a completed iteration (root best move, its score and its share of the
+    // iteration's root nodes). True when the next iteration should not be started.
+    bool iterationDone(const Move& best, int score, double bestNodeShare, clock::time_point now) noexcept;
+
+    // Current multiplier of optimumMs (1 = normal position)
+    double scale() const noexcept { return scale_; }
+    Limits limits() const noexcept { return { optimumMs_.load(std::memory_order_relaxed), hardMs_.load(std::memory_order_relaxed) }; }
+
+private:
+    std::atomic<int> optimumMs_;
+    std::atomic<int> hardMs_;
+    const SearchDeadline& deadline_;
+    Move lastBest_ { Pos { 255, 255 }, Player::Black };
+    int lastScore_ = 0;
+    int iterations_ = 0;
+    int stableIterations_ = 0; // consecutive iterations with the same move and close score
+    double instability_ = 0.0; // best-move flips, halved at every iteration
+    double scale_ = 1.0;
+};
+
+} // namespace gomoku
@@ -0,0 +1,30 @@
+#pragma once
+#include "gomoku/ai/TranspositionTable.hpp"
+#include "gomoku/core/Types.hpp"
+#include <cstddef>
+#include <memory>
+
+// Process-wide transposition table for engines built with SearchConfig::sharedTT.
+// However many sessions are alive, they all search into one table of budgetBytes(), so the
+// TT footprint of the process is fixed. Sharing is sound because TT keys identify the
+// position and the rules (search::ttKey); an idle session holds a reference, not memory.
+// The table is faulted in when created (TranspositionTable::prefault), since every session
+// fills it, and unmapped when the last engine using it is destroyed.
+namespace gomoku::inline GOMOKU_SIZE_NS::ttpool {
+
+inline constexpr std::size_t DEFAULT_BUDGET_BYTES = 128ull << 20;
+
+// Global byte budget (never exceeded: the table takes the largest power of two that fits).
+// A budget below TranspositionTable::MIN_BYTES (16 KB, the smallest table) is raised to it:
+// budgetBytes() reports the budget actually applied. 0 = DEFAULT_BUDGET_BYTES.
+// A table already alive keeps its size; the budget applies to the next one created.
+void setBudgetBytes(std::size_t bytes);
+std::size_t budgetBytes();
+
+// The shared table (created at the budget size if none is alive).
+std::shared_ptr<TranspositionTable> acquire();
+
+// Bytes currently mapped by the pool (0 when no engine holds the table).
+std::size_t liveBytes();
+
+} // namespace gomoku::ttpool
@@ -1,12 +1,25 @@
 #pragma once
 #include "gomoku/core/Types.hpp"
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
-#include <vector>
+#include <string>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
+// Shared between search threads (Lazy SMP) without locks. The table is an array of
+// cache-line buckets, each holding BUCKET_SIZE 16-byte entries { key ^ data, data }: an
+// entry torn by a concurrent store fails the XOR check and reads as a miss.
+// Replacement inside a bucket prefers empty slots, then the shallowest / oldest entry
+// (generation counter bumped by newSearch()).
+// Memory is an anonymous mapping of 4 KB pages faulted in on demand: sizing a table does
+// not write it. hugetlb pages (reserved memory) are faulted in by resizeBytes, and
+// prefault() faults a table in at once, on transparent huge pages. clear() only moves the first live generation: clearing never writes the
+// table. Generations are 8-bit:
+// each newSearch() zeroes the dead entries (cleared or older than LIVE_SPAN searches) of one
+// slice of the table, so no entry reaches the age of 256 at which its generation would wrap
+// back into the live window.
 class TranspositionTable {
 public:
     enum class Flag : uint8_t { Exact,
@@ -20,46 +33,175 @@ public:
         Move best { Pos { 255, 255 }, Player::Black }; // stored best move; (255,255) = invalid sentinel
     };
 
+    static constexpr int BUCKET_SIZE = 4;
+    static constexpr int LIVE_SPAN = 128; // recherches dont les entrées restent visibles
+    static constexpr int SCRUB_PERIOD = 64; // newSearch() pour balayer toute la table
+    static_assert(LIVE_SPAN + SCRUB_PERIOD < 256, "dead entries are scrubbed before their generation wraps");
+    static constexpr std::size_t MIN_BUCKETS = 256;
+    static constexpr std::size_t MIN_BYTES = MIN_BUCKETS * 64; // plus petite table : 16 KB
+    static_assert(MIN_BUCKETS % SCRUB_PERIOD == 0, "every scrub slice holds whole buckets");
+
     TranspositionTable() = default;
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Maps a table of about `bytes` (power-of-two bucket count, at least MIN_BYTES); same
+    // size = clear().
+    void resizeBytes(std::size_t bytes);
+
+    // O(1): every entry stored so far reads as empty.
+    void clear() noexcept
+    {
+        newSearch();
+        firstGen.store(generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // Starts a new search: entries from earlier searches become preferred victims, and those
+    // of the last LIVE_SPAN searches only stay live. Also scrubs 1/SCRUB_PERIOD of the table.
+    // Safe while other threads search (a shared table ages with every session's searches).
+    void newSearch() noexcept;
 
-    void resizeBytes(std::size_t bytes)
+    std::size_t bytes() const noexcept { return table ? (mask + 1) * sizeof(Bucket) : 0; }
+    // Persistence: versioned file = 4 KB header + raw buckets (live entries only). The
+    // fingerprint ties the file to the Zobrist keys and rules it was searched with
+    // (search::ttFingerprint); version, board size or fingerprint mismatches are rejected.
+    bool saveFile(const std::string& path, uint64_t fingerprint) const;
+    // Replaces the table with the file's (its size wins over resizeBytes). The file is mapped
+    // copy-on-write: pages are read on first probe and the file itself is never modified.
+    bool loadFile(const std::string& path, uint64_t fingerprint);
+
+    // Backed by 2 MB pages (MAP_HUGETLB, or transparent huge pages granted to prefault())
+    bool hugePages() const noexcept { return hugePages_; }
+    // Faults every page of the table in now, so that no search pays for it, on transparent
+    // huge pages where the system allows them. Keeps the entries; no-op on a loaded file.
+    // Costs the whole table in resident memory: for a table that will be filled.
+    void prefault() noexcept;
+    // Every page already faulted in (prefault(), hugetlb pages, or a heap table)
+    bool faultedIn() const noexcept { return faultedIn_; }
+
+    // Starts loading the bucket of key; call once the key is known, well before probe().
+    void prefetch(uint64_t key) const noexcept
     {
-        if (!bytes)
-            bytes = (16ull << 20);
-        std::size_t n = bytes / sizeof(Entry);
-        if (n < 1024)
-            n = 1024;
-        std::size_t pow2 = 1;
-        while (pow2 < n)
-            pow2 <<= 1;
-        table.assign(pow2, Entry {});
-        mask = pow2 - 1;
+#if defined(__GNUC__) || defined(__clang__)
+        if (table)
+            __builtin_prefetch(&table[key & mask]);
+#else
+        (void)key;
+#endif
     }
 
-    Entry* probe(uint64_t key) const
+    // Copies the entry stored for key into out. False if no slot of the bucket holds key
+    // (or the one that did was being rewritten by another thread).
+    bool probe(uint64_t key, Entry& out) const noexcept
     {
-        if (table.empty())
-            return nullptr;
-        return const_cast<Entry*>(&table[key & mask]);
+        if (!table)
+            return false;
+        for (Slot& s : table[key & mask].slots) {
+            const uint64_t data = load(s.data);
+            if (live(data) && (load(s.check) ^ data) == key) {
+                out = unpack(key, data);
+                return true;
+            }
+        }
+        return false;
     }
 
-    void store(uint64_t key, int depth, int score, Flag flag, const std::optional<Move>& best)
+    void store(uint64_t key, int depth, int score, Flag flag, const std::optional<Move>& best) noexcept
     {
-        if (table.empty())
+        if (!table)
             return;
-        auto& e = table[key & mask];
-        if (e.key != key || depth >= e.depth) {
-            e.key = key;
-            e.depth = depth;
-            e.score = score;
-            e.flag = flag;
-            e.best = best.value_or(Move { Pos { 255, 255 }, Player::Black });
+        Bucket& b = table[key & mask];
+        Slot* victim = nullptr;
+        int victimWorth = 0;
+        uint64_t data = pack(depth, score, flag, best);
+        for (Slot& s : b.slots) {
+            const uint64_t old = load(s.data);
+            const bool used = live(old);
+            if (used && (load(s.check) ^ old) == key) {
+                // Same position: keep the deeper result of the current search
+                if (depth < depthOf(old) && genOf(old) == generation.load(std::memory_order_relaxed))
+                    return;
+                if (!best && (old & HAS_MOVE))
+                    data |= old & MOVE_BITS; // keep the known best move for ordering
+                victim = &s;
+                break;
+            }
+            // Worth of keeping the slot: empty first, then depth minus 8 plies per search of age
+            const int worth = used ? depthOf(old) - 8 * static_cast<uint8_t>(generation.load(std::memory_order_relaxed) - genOf(old)) : -4096;
+            if (!victim || worth < victimWorth) {
+                victim = &s;
+                victimWorth = worth;
+            }
         }
+        std::atomic_ref<uint64_t>(victim->check).store(key ^ data, std::memory_order_relaxed);
+        std::atomic_ref<uint64_t>(victim->data).store(data, std::memory_order_relaxed);
     }
 
 private:
-    std::vector<Entry> table;
+    // Plain words accessed through atomic_ref so that zero-filled pages are valid empty slots
+    struct Slot {
+        alignas(8) uint64_t check; // key ^ data
+        uint64_t data;
+    };
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+    static_assert(sizeof(Slot) == 16 && sizeof(Bucket) == 64, "one bucket per cache line");
+
+    // data layout: score [0,32) | depth [32,40) | flag [40,42) | x [42,47) | y [47,52) | by [52]
+    //              | has move [53] | generation [54,62) | used [62]
+    static constexpr uint64_t HAS_MOVE = 1ull << 53;
+    static constexpr uint64_t MOVE_BITS = (0x7FFull << 42) | HAS_MOVE;
+    static constexpr uint64_t GEN_BITS = 0xFFull << 54;
+    static constexpr uint64_t USED = 1ull << 62;
+    static_assert(BOARD_SIZE <= 32, "moves are packed on 5-bit coordinates");
+
+    static uint64_t load(uint64_t& word) noexcept { return std::atomic_ref<uint64_t>(word).load(std::memory_order_relaxed); }
+    // Used and stored since the last clear()
+    bool live(uint64_t data) const noexcept
+    {
+        const uint8_t g = generation.load(std::memory_order_relaxed);
+        return (data & USED) && static_cast<uint8_t>(g - genOf(data)) <= static_cast<uint8_t>(g - firstGen.load(std::memory_order_relaxed));
+    }
+
+    static int depthOf(uint64_t data) noexcept { return static_cast<int>((data >> 32) & 0xFF); }
+    static uint8_t genOf(uint64_t data) noexcept { return static_cast<uint8_t>(data >> 54); }
+
+    uint64_t pack(int depth, int score, Flag flag, const std::optional<Move>& best) const noexcept
+    {
+        const uint64_t d = static_cast<uint64_t>(depth < 0 ? 0 : depth > 255 ? 255 : depth);
+        uint64_t data = static_cast<uint64_t>(static_cast<uint32_t>(score)) | (d << 32)
+            | (static_cast<uint64_t>(flag) << 40) | (static_cast<uint64_t>(generation.load(std::memory_order_relaxed)) << 54) | USED;
+        if (best && best->isValid())
+            data |= (static_cast<uint64_t>(best->pos.x) << 42) | (static_cast<uint64_t>(best->pos.y) << 47)
+                | (static_cast<uint64_t>(best->by == Player::White) << 52) | HAS_MOVE;
+        return data;
+    }
+
+    static Entry unpack(uint64_t key, uint64_t data) noexcept
+    {
+        Entry e;
+        e.key = key;
+        e.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+        e.depth = depthOf(data);
+        e.flag = static_cast<Flag>((data >> 40) & 0x3);
+        if (data & HAS_MOVE)
+            e.best = Move { Pos { static_cast<uint8_t>((data >> 42) & 0x1F), static_cast<uint8_t>((data >> 47) & 0x1F) },
+                ((data >> 52) & 1) ? Player::White : Player::Black };
+        return e;
+    }
+
+    void release() noexcept;
+
+    Bucket* table = nullptr;
     std::size_t mask = 0;
+    bool hugePages_ = false;
+    bool faultedIn_ = false;
+    void* fileMap_ = nullptr; // mapping of a loaded file (table points past its header)
+    std::size_t fileMapBytes_ = 0;
+    std::atomic<uint8_t> generation { 0 };
+    std::atomic<uint8_t> firstGen { 0 }; // oldest generation still live (moved forward by clear())
 };
 
 } // namespace gomoku
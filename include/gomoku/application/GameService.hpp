@@ -7,11 +7,11 @@
 #include <vector>
 
 // Forward declarations
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 class Board;
 }
 
-namespace gomoku::application {
+namespace gomoku::inline GOMOKU_SIZE_NS::application {
 
 class GameService : public IGameService {
 public:
@@ -50,8 +50,18 @@ public:
     const RuleSet& getRules() const { return rules_; }
 
     // AI integration
+    // After a ponder hit this finishes the pondered search within timeMs
     std::optional<Move> getAIMove(int timeMs = 500, SearchStats* outStats = nullptr);
     void setSearchEngine(std::unique_ptr<ISearchEngine> engine);
+    // Clock of the side the next getAIMove() searches for (remainingMs > 0 replaces timeMs)
+    void setGameClock(const GameClock& clock);
+
+    // Pondering: pv is the principal variation of the AI move just played; its reply pv[1]
+    // is searched in the background. Playing that reply is a ponder hit (the next
+    // getAIMove() continues the search); any other move or history change aborts it.
+    bool startPondering(const std::vector<Move>& pv);
+    void stopPondering();
+    bool isPondering() const { return ponderMove_.has_value(); }
 
 private:
     // Core game state
@@ -63,6 +73,10 @@ private:
     std::unique_ptr<ISearchEngine> searchEngine_;
     MoveValidator moveValidator_;
 
+    // Pondering state: expected reply, and whether it has been played
+    std::optional<Move> ponderMove_;
+    bool ponderHit_ = false;
+
     // Internal helpers
     bool validateMove(const Move& move, std::string* reason) const;
 };
@@ -3,7 +3,7 @@
 #include "gomoku/interfaces/IBoardView.hpp"
 #include <string>
 
-namespace gomoku::application {
+namespace gomoku::inline GOMOKU_SIZE_NS::application {
 
 /**
  * Validation basique d'un coup côté service avant tentative d'application sur Board.
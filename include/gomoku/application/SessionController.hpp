@@ -3,12 +3,14 @@
 #include "gomoku/application/GameService.hpp"
 #include "gomoku/core/Types.hpp"
 #include "gomoku/interfaces/IBoardView.hpp"
+#include <array>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 struct GameSnapshot {
     const IBoardView* view; // Current board view
@@ -43,6 +45,16 @@ public:
     void setController(Player side, Controller c);
     Controller controller(Player side) const;
 
+    // Pondering: after each AI move, search the expected human reply until it is played
+    void setPondering(bool enabled);
+    bool pondering() const { return pondering_; }
+
+    // Time control (main time + increment per move, mainMs 0 = none): each side's clock runs
+    // from the end of the previous move to its own move, and AI moves are searched on the
+    // clock of their side instead of playAI's timeMs. reset() restores the main time.
+    void setTimeControl(int mainMs, int incrementMs = 0);
+    GameClock clock(Player side) const { return clocks_[side == Player::Black ? 0 : 1]; }
+
     // Moves
     GamePlayResult playHuman(Pos p); // validate + play
     GamePlayResult playAI(int timeMs = 500); // search + play
@@ -65,8 +77,15 @@ private:
     std::optional<Pos> last_;
     Controller black_ = Controller::Human;
     Controller white_ = Controller::AI;
+    bool pondering_ = false;
+    int mainMs_ = 0;
+    int incrementMs_ = 0;
+    std::array<GameClock, 2> clocks_ {}; // Black, White
+    std::chrono::steady_clock::time_point turnStart_ { std::chrono::steady_clock::now() };
 
     Controller ctrl(Player p) const { return (p == Player::Black ? black_ : white_); }
+    // Charges the time since turnStart_ to 'mover' (then adds the increment) and restarts the turn
+    void chargeClock(Player mover);
 };
 
 } // namespace gomoku
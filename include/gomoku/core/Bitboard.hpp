@@ -0,0 +1,215 @@
+#pragma once
+
+#include "gomoku/core/Types.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+// Fixed-size bitset over the board cells (bit i <=> linear index y * BOARD_SIZE + x).
+// Words are exposed so callers can scan 64 cells at a time.
+struct Bitboard {
+    static constexpr int CELLS = BOARD_SIZE * BOARD_SIZE;
+    static constexpr int WORDS = (CELLS + 63) / 64;
+
+    std::array<uint64_t, WORDS> w {};
+
+    constexpr void set(int i) noexcept { w[i >> 6] |= (1ull << (i & 63)); }
+    constexpr void reset(int i) noexcept { w[i >> 6] &= ~(1ull << (i & 63)); }
+    constexpr bool test(int i) const noexcept { return (w[i >> 6] >> (i & 63)) & 1ull; }
+    constexpr void clear() noexcept { w.fill(0); }
+
+    // Sets bits [from, to] (inclusive), word by word
+    constexpr void setRange(int from, int to) noexcept
+    {
+        while (from <= to) {
+            const int word = from >> 6;
+            const int lo = from & 63;
+            const int hi = (word == (to >> 6)) ? (to & 63) : 63;
+            const uint64_t span = (hi - lo == 63) ? ~0ull : (((1ull << (hi - lo + 1)) - 1) << lo);
+            w[word] |= span;
+            from = (word + 1) << 6;
+        }
+    }
+
+    constexpr bool any() const noexcept
+    {
+        for (uint64_t v : w)
+            if (v)
+                return true;
+        return false;
+    }
+
+    constexpr int count() const noexcept
+    {
+        int n = 0;
+        for (uint64_t v : w)
+            n += std::popcount(v);
+        return n;
+    }
+
+    constexpr Bitboard& operator|=(const Bitboard& o) noexcept
+    {
+        for (int k = 0; k < WORDS; ++k)
+            w[k] |= o.w[k];
+        return *this;
+    }
+    constexpr Bitboard& operator&=(const Bitboard& o) noexcept
+    {
+        for (int k = 0; k < WORDS; ++k)
+            w[k] &= o.w[k];
+        return *this;
+    }
+    // this &= ~o (no need to mask the padding bits of the last word)
+    constexpr Bitboard& andNot(const Bitboard& o) noexcept
+    {
+        for (int k = 0; k < WORDS; ++k)
+            w[k] &= ~o.w[k];
+        return *this;
+    }
+    friend constexpr Bitboard operator|(Bitboard a, const Bitboard& b) noexcept { return a |= b; }
+    friend constexpr Bitboard operator&(Bitboard a, const Bitboard& b) noexcept { return a &= b; }
+    constexpr bool operator==(const Bitboard& o) const noexcept { return w == o.w; }
+
+    // Calls f(linearIndex) for every set bit, in increasing index order
+    template <class F>
+    constexpr void forEach(F&& f) const
+    {
+        for (int k = 0; k < WORDS; ++k) {
+            uint64_t v = w[k];
+            while (v) {
+                const int bit = std::countr_zero(v);
+                f(static_cast<uint16_t>((k << 6) + bit));
+                v &= v - 1;
+            }
+        }
+    }
+};
+
+// Line-rotated geometry: every cell belongs to exactly one line per direction.
+// Directions follow the engine convention { (1,0), (0,1), (1,1), (1,-1) }.
+// Along a line, cell bits are numbered so that stepping +dir increments the bit:
+//   dir 0 (row)       line = y,                  bit = x
+//   dir 1 (column)    line = x,                  bit = y
+//   dir 2 (diagonal)  line = x - y + SIZE - 1,   bit = x
+//   dir 3 (anti-diag) line = x + y,              bit = x
+namespace lines {
+
+    inline constexpr int DIRS = 4;
+    inline constexpr int COUNT = 2 * BOARD_SIZE - 1; // lines per direction (37 on 19x19)
+    static_assert(BOARD_SIZE <= 32, "line words are 32-bit");
+
+    struct Coord {
+        uint8_t line;
+        uint8_t bit;
+    };
+
+    constexpr Coord coordOf(int d, int x, int y)
+    {
+        switch (d) {
+        case 0:
+            return { static_cast<uint8_t>(y), static_cast<uint8_t>(x) };
+        case 1:
+            return { static_cast<uint8_t>(x), static_cast<uint8_t>(y) };
+        case 2:
+            return { static_cast<uint8_t>(x - y + BOARD_SIZE - 1), static_cast<uint8_t>(x) };
+        default:
+            return { static_cast<uint8_t>(x + y), static_cast<uint8_t>(x) };
+        }
+    }
+
+    // Flat cell index of bit 'bit' of line 'line' along d (inverse of coordOf)
+    constexpr uint16_t cellIndex(int d, int line, int bit)
+    {
+        switch (d) {
+        case 0:
+            return static_cast<uint16_t>(line * BOARD_SIZE + bit);
+        case 1:
+            return static_cast<uint16_t>(bit * BOARD_SIZE + line);
+        case 2:
+            return static_cast<uint16_t>((bit - line + BOARD_SIZE - 1) * BOARD_SIZE + bit);
+        default:
+            return static_cast<uint16_t>((line - bit) * BOARD_SIZE + bit);
+        }
+    }
+
+    constexpr std::array<std::array<Coord, BOARD_SIZE * BOARD_SIZE>, DIRS> makeCoords()
+    {
+        std::array<std::array<Coord, BOARD_SIZE * BOARD_SIZE>, DIRS> t {};
+        for (int d = 0; d < DIRS; ++d)
+            for (int y = 0; y < BOARD_SIZE; ++y)
+                for (int x = 0; x < BOARD_SIZE; ++x)
+                    t[d][y * BOARD_SIZE + x] = coordOf(d, x, y);
+        return t;
+    }
+
+    // Bits of each line that map to an on-board cell
+    constexpr std::array<std::array<uint32_t, COUNT>, DIRS> makeValid()
+    {
+        std::array<std::array<uint32_t, COUNT>, DIRS> t {};
+        for (int d = 0; d < DIRS; ++d)
+            for (int y = 0; y < BOARD_SIZE; ++y)
+                for (int x = 0; x < BOARD_SIZE; ++x) {
+                    const Coord c = coordOf(d, x, y);
+                    t[d][c.line] |= (1u << c.bit);
+                }
+        return t;
+    }
+
+    inline constexpr auto coords = makeCoords();
+    inline constexpr auto valid = makeValid();
+
+    // Packed line codes: 2 bits per cell (see LineShapes.hpp for the cell codes), cell k of a
+    // line at bits [2 * (k + CODE_PAD), +1]. CODE_PAD wall cells on each side let any window
+    // of radius <= CODE_PAD be cut out with a single shift, even at the board edge.
+    inline constexpr int CODE_PAD = 5;
+    static_assert(2 * (BOARD_SIZE + 2 * CODE_PAD) <= 64, "line code must fit in 64 bits");
+
+    constexpr int codeShift(int bit) noexcept { return 2 * (bit + CODE_PAD); }
+
+    // Code of a line with no stone: every off-board cell (and the padding) reads as wall (0b11)
+    constexpr std::array<std::array<uint64_t, COUNT>, DIRS> makeEmptyCodes()
+    {
+        std::array<std::array<uint64_t, COUNT>, DIRS> t {};
+        for (int d = 0; d < DIRS; ++d)
+            for (int line = 0; line < COUNT; ++line) {
+                uint64_t code = ~0ull;
+                for (int k = 0; k < BOARD_SIZE; ++k)
+                    if ((valid[d][line] >> k) & 1u)
+                        code &= ~(3ull << codeShift(k));
+                t[d][line] = code;
+            }
+        return t;
+    }
+    inline constexpr auto emptyCodes = makeEmptyCodes();
+
+    // Bit helpers on line words (k may fall outside [0, 63]: reads as 0)
+    constexpr bool test(uint64_t word, int k) noexcept
+    {
+        return k >= 0 && k < 64 && ((word >> k) & 1ull);
+    }
+    // Number of consecutive set bits starting at k going up
+    constexpr int runUp(uint64_t word, int k) noexcept
+    {
+        return (k < 0 || k >= 64) ? 0 : std::countr_one(word >> k);
+    }
+    // Number of consecutive set bits starting at k going down
+    constexpr int runDown(uint64_t word, int k) noexcept
+    {
+        return (k < 0 || k >= 64) ? 0 : std::countl_one(word << (63 - k));
+    }
+    // True if the word holds 5 or more consecutive set bits
+    constexpr bool hasFive(uint64_t m) noexcept
+    {
+        return (m & (m >> 1) & (m >> 2) & (m >> 3) & (m >> 4)) != 0;
+    }
+    // Population count of bits [from, from + len)
+    constexpr int countIn(uint64_t word, int from, int len) noexcept
+    {
+        return std::popcount((word >> from) & ((1ull << len) - 1));
+    }
+
+} // namespace lines
+
+} // namespace gomoku
@@ -11,7 +11,7 @@
 #include <string>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 // Implémentation concrète de IBoardView pour libgomoku_logic.a
 class Board final : public IBoardView {
@@ -43,6 +43,8 @@ public:
 
     // Last k moves (most recent first). Returns up to k moves.
     std::vector<Move> lastMoves(std::size_t k) const;
+    // Non-allocating variant: writes up to k moves (most recent first) into out, returns the count.
+    std::size_t lastMoves(std::size_t k, Move* out) const noexcept;
 
     PlayResult tryPlay(Move m, const RuleSet& rules);
     bool wouldCapture(Move m) const { return capture::wouldCapture(state, m); }
@@ -52,6 +54,27 @@ public:
 
     bool speculativeTry(Move m, const RuleSet& rules, PlayResult* out);
 
+    // Search-grade make/unmake: same rules as tryPlay, but no error message, no redo
+    // bookkeeping and no heap allocation (fixed-size undo entries on a reserved stack).
+    // unmakeMove must pair with a successful makeMove.
+    bool makeMove(Move m, const RuleSet& rules);
+    void unmakeMove() noexcept;
+
+    // Undo stack as seen by incremental evaluators: move i (oldest first), the stones it
+    // captured and the Zobrist key of the position before it
+    struct HistoryDelta {
+        Move move;
+        const Pos* captured;
+        int capturedCount;
+        uint64_t keyBefore;
+    };
+    std::size_t historySize() const noexcept { return moveHistory.size(); }
+    HistoryDelta historyDelta(std::size_t i) const noexcept
+    {
+        const UndoEntry& u = moveHistory[i];
+        return { u.move, u.capturedStones.data(), u.capturedCount, u.zobristBefore };
+    }
+
     // Persistence
     std::vector<uint8_t> save() const;
     bool load(const std::vector<uint8_t>& data, const RuleSet& rules);
@@ -66,6 +89,9 @@ public:
     // Sparse occupied cells accessor (for fast scans in generators/eval)
     const std::vector<Pos>& occupiedPositions() const;
 
+    // Raw state accessor (bitboards and line words for word-at-a-time scans)
+    const BoardState& rawState() const { return state; }
+
     const std::vector<Move>& getRedoHistory() const { return redoHistory; }
 
 private:
@@ -79,7 +105,8 @@ private:
 
     struct UndoEntry {
         Move move {};
-        std::vector<Pos> capturedStones; // pierres capturées
+        capture::CaptureBuffer capturedStones {}; // pierres capturées [0, capturedCount)
+        uint8_t capturedCount { 0 };
         int blackPairsBefore { 0 }, whitePairsBefore { 0 };
         int blackStonesBefore { 0 }, whiteStonesBefore { 0 };
         GameStatus stateBefore { GameStatus::Ongoing };
@@ -92,7 +119,15 @@ private:
     static_assert(BOARD_SIZE * BOARD_SIZE < std::numeric_limits<int16_t>::max(), "occIdx_ requires N < int16_t::max");
 
     // Facteur interne : logique partagée d'application. Si record=true, pousse UndoEntry.
-    PlayResult applyCore(Move m, const RuleSet& rules, bool record, bool clearRedo = true);
+    // En cas d'échec, *reason (si fourni) pointe sur un message statique.
+    PlayErrorCode applyCore(Move m, const RuleSet& rules, bool record, const char** reason = nullptr);
+    // Noyau spécialisé par politique de règles (RulePolicy.hpp), choisi une fois par applyCore
+    template <class P>
+    PlayErrorCode applyKernel(Move m, const RuleSet& rules, bool record, const char** reason);
+    template <class P>
+    std::vector<Move> legalMovesFor(Player p) const;
+    // Annule la dernière UndoEntry (sans toucher à redoHistory)
+    void revertLast() noexcept;
 
     // capture logic moved to CaptureEngine (free functions)
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "gomoku/core/Bitboard.hpp"
 #include "gomoku/core/Types.hpp"
 #include "gomoku/core/Zobrist.hpp"
 #include <array>
@@ -7,19 +8,32 @@
 #include <limits>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 // Lightweight container for the board's internal state.
 // It stores only data and provides tiny helpers to maintain invariants.
 //
+// Storage: cells live in a padded (BOARD_SIZE + 2 * PAD)^2 grid whose border holds
+// Cell::Wall. idx() stays the dense 0..N-1 id used by bitboards, tables and Pos;
+// slot() is the padded storage index, reached through getCell() or cellAtSlot().
+//
 // Invariants:
-// - cells holds the content of every board position.
-// - occIdx_[i] == -1 if and only if cells[i] == Cell::Empty.
+// - grid_[slot(p)] holds the content of every board position; border slots are Wall.
+// - occIdx_[i] == -1 if and only if cell i is Cell::Empty.
 // - For any non-empty cell at linear index i, occIdx_[i] is a valid index
 //   into occupied_, and occupied_[occIdx_[i]] is the corresponding Pos.
 // - Stone counters (blackStones/whiteStones) match the content of cells.
-// - zobristHash is kept in sync by set/clear operations and flipSide().
-//   It encodes the side-to-move bit if flipSide/reset was used appropriately.
+// - zobristHash is kept in sync by set/clear operations, setPairs/addPairs and flipSide().
+//   It encodes the side-to-move bit if flipSide/reset was used appropriately, and
+//   both captured-pair counters (writing blackPairs/whitePairs directly must be
+//   paired with restoring a saved hash, as undo does).
+// - stones_[k] (k = 0 Black, 1 White) has bit i set iff cell i holds that color.
+// - lineBits_[k][d][line] mirrors stones_[k] along each of the 4 directions
+//   (see lines::coords), so a whole row/column/diagonal reads as one word.
+// - lineCode_[d][line] packs the same line as 2-bit cell codes (Empty/Black/White,
+//   off-board reads as wall), so a window around any cell is a single shift.
+// - fiveLines_[k][d] has bit 'line' set iff lineBits_[k][d][line] holds a 5+ run,
+//   so "does color k have a five anywhere" is four word tests.
 class BoardState final {
 public:
     static constexpr int N = BOARD_SIZE * BOARD_SIZE;
@@ -32,8 +46,22 @@ public:
         return idx(p.x, p.y);
     }
 
+    // Padded storage: walking up to PAD steps from any board cell stays in the grid and
+    // reads Wall past the edge, so such walks need no bounds check.
+    static constexpr int PAD = 2;
+    static constexpr int STRIDE = BOARD_SIZE + 2 * PAD;
+    static constexpr int PADDED_N = STRIDE * STRIDE;
+    static constexpr int slot(uint8_t x, uint8_t y) noexcept { return (y + PAD) * STRIDE + x + PAD; }
+    static constexpr int slot(Pos p) noexcept { return slot(p.x, p.y); }
+    // Slot offset of one step along each direction { (1,0), (0,1), (1,1), (1,-1) }
+    static constexpr int SLOT_STEP[4] = { 1, STRIDE, STRIDE + 1, 1 - STRIDE };
+    // Dense id of an on-board slot
+    static constexpr uint16_t idxOfSlot(int s) noexcept
+    {
+        return static_cast<uint16_t>((s / STRIDE - PAD) * BOARD_SIZE + s % STRIDE - PAD);
+    }
+
     // Raw storage
-    std::array<Cell, N> cells {};
     std::vector<Pos> occupied_;
     std::array<int16_t, N> occIdx_ {};
 
@@ -52,13 +80,14 @@ public:
 
     // Basic queries
     bool isInside(uint8_t x, uint8_t y) const noexcept { return x < BOARD_SIZE && y < BOARD_SIZE; }
-    bool isEmpty(uint8_t x, uint8_t y) const noexcept { return cells[idx(x, y)] == Cell::Empty; }
+    bool isEmpty(uint8_t x, uint8_t y) const noexcept { return grid_[slot(x, y)] == Cell::Empty; }
 
     // Cell operations (do NOT touch occupied_ by design; combine with add/removeOccupied)
     // - setCell: set a cell to c and keep stone counters and hash in sync
     // - clearCell: set a cell to Empty and keep counters/hash in sync
-    Cell getCell(uint8_t x, uint8_t y) const noexcept { return cells[idx(x, y)]; }
-    Cell getCell(Pos p) const noexcept { return cells[idx(p)]; }
+    Cell getCell(uint8_t x, uint8_t y) const noexcept { return grid_[slot(x, y)]; }
+    Cell getCell(Pos p) const noexcept { return grid_[slot(p)]; }
+    Cell cellAtSlot(int s) const noexcept { return grid_[s]; }
     bool isFull() const noexcept { return occupied_.size() == N; }
 
     // High-level helpers keeping invariants automatically
@@ -73,6 +102,52 @@ public:
         removeOccupied(p);
     }
 
+    // ---- Bitboard queries (word-at-a-time scans) ----
+    static constexpr int colorIndex(Cell c) noexcept { return c == Cell::White ? 1 : 0; }
+
+    // Per-color occupancy over the whole board (c must not be Empty)
+    const Bitboard& stones(Cell c) const noexcept { return stones_[colorIndex(c)]; }
+    Bitboard occupancy() const noexcept { return stones_[0] | stones_[1]; }
+
+    // Line word of color c for direction d holding p; p's position in it is lines::coords[d][idx(p)].bit
+    uint32_t lineBits(Cell c, int d, Pos p) const noexcept
+    {
+        return lineBits_[colorIndex(c)][d][lines::coords[d][idx(p)].line];
+    }
+    uint32_t lineBits(Cell c, int d, int line) const noexcept { return lineBits_[colorIndex(c)][d][line]; }
+    // Empty on-board cells of a line
+    uint32_t lineEmpty(int d, int line) const noexcept
+    {
+        return lines::valid[d][line] & ~(lineBits_[0][d][line] | lineBits_[1][d][line]);
+    }
+
+    // Lines of direction d (bit = line number) where c has 5 or more in a row
+    uint64_t fiveLines(Cell c, int d) const noexcept { return fiveLines_[colorIndex(c)][d]; }
+    bool hasFive(Cell c) const noexcept
+    {
+        const auto& f = fiveLines_[colorIndex(c)];
+        return (f[0] | f[1] | f[2] | f[3]) != 0;
+    }
+
+    // Packed 2-bit codes of the 2*radius+1 cells centred on p along d (see LineShapes.hpp).
+    // Cell p - radius*dir sits in the low bits; off-board cells read as shapes::WALL.
+    uint32_t lineWindow(int d, Pos p, int radius) const noexcept
+    {
+        const lines::Coord lc = lines::coords[d][idx(p)];
+        const uint64_t mask = (1ull << (2 * (2 * radius + 1))) - 1;
+        return static_cast<uint32_t>((lineCode_[d][lc.line] >> lines::codeShift(lc.bit - radius)) & mask);
+    }
+
+    // Captured-pair counters, keeping zobristHash in sync
+    int pairs(Cell c) const noexcept { return c == Cell::White ? whitePairs : blackPairs; }
+    void setPairs(Cell c, int n) noexcept
+    {
+        int& ref = (c == Cell::White) ? whitePairs : blackPairs;
+        zobristHash ^= zobrist::pairs(c, ref) ^ zobrist::pairs(c, n);
+        ref = n;
+    }
+    void addPairs(Cell c, int n) noexcept { setPairs(c, pairs(c) + n); }
+
     // Toggle side-to-move bit in zobristHash
     void flipSide() noexcept { zobristHash ^= zobrist::side(); }
 
@@ -86,6 +161,14 @@ private:
     void clearCell(uint8_t x, uint8_t y) noexcept;
     void addOccupied(Pos p) noexcept;
     void removeOccupied(Pos p) noexcept;
+    void toggleBits(uint16_t i, Cell c) noexcept;
+
+    std::array<Cell, PADDED_N> grid_ {};
+    std::array<Bitboard, 2> stones_ {};
+    std::array<std::array<std::array<uint32_t, lines::COUNT>, lines::DIRS>, 2> lineBits_ {};
+    std::array<std::array<uint64_t, lines::COUNT>, lines::DIRS> lineCode_ = lines::emptyCodes;
+    std::array<std::array<uint64_t, lines::DIRS>, 2> fiveLines_ {};
+    static_assert(lines::COUNT <= 64, "fiveLines_ holds one bit per line");
 };
 
 } // namespace gomoku
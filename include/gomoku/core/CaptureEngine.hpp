@@ -2,9 +2,14 @@
 
 #include "gomoku/core/BoardState.hpp"
 #include "gomoku/core/Types.hpp"
+#include <array>
 #include <vector>
 
-namespace gomoku::capture {
+namespace gomoku::inline GOMOKU_SIZE_NS::capture {
+
+// Upper bound of stones removed by one move: one pair on each side of the 4 directions.
+inline constexpr int MAX_CAPTURED_STONES = 16;
+using CaptureBuffer = std::array<Pos, MAX_CAPTURED_STONES>;
 
 // Compute and apply captures generated by placing a stone of color `who` at
 // position `p`. Mutates `state` by removing captured stones. Appends removed
@@ -12,6 +17,16 @@ namespace gomoku::capture {
 // If captures are disabled in `rules`, returns 0 and performs no mutation.
 int applyCapturesAround(BoardState& state, Pos p, Cell who, const RuleSet& rules, std::vector<Pos>& removed);
 
+// Same as above without heap traffic: removed stones are written to removed[0 .. 2 * pairs).
+int applyCapturesAround(BoardState& state, Pos p, Cell who, const RuleSet& rules, CaptureBuffer& removed) noexcept;
+
+// Kernel for callers that already know captures are enabled (no RuleSet test).
+int applyCaptures(BoardState& state, Pos p, Cell who, CaptureBuffer& removed) noexcept;
+
+// Lists the stones move `m` would capture into removed[0 .. 2 * pairs) without
+// mutating `state` (captures-enabled check is left to the caller). Returns the pair count.
+int findCaptures(const BoardState& state, Move m, CaptureBuffer& removed) noexcept;
+
 // Check if placing move `m` would create at least one XOOX capture pattern.
 // Does NOT mutate `state`.
 bool wouldCapture(const BoardState& state, Move m) noexcept;
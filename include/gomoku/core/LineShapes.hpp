@@ -0,0 +1,85 @@
+#pragma once
+
+#include "gomoku/core/Types.hpp"
+#include <array>
+#include <cstdint>
+
+// Lookup tables over packed line windows (2 bits per cell, first cell in the low bits).
+// Windows come from BoardState::lineWindow; tables are written from Black's point of view,
+// use relative() to look at a window from White's side.
+namespace gomoku::inline GOMOKU_SIZE_NS::shapes {
+
+inline constexpr uint32_t EMPTY = 0;
+inline constexpr uint32_t OWN = 1; // Black in absolute windows
+inline constexpr uint32_t OTHER = 2; // White in absolute windows
+inline constexpr uint32_t WALL = 3; // off-board
+
+constexpr uint32_t code(Cell c) noexcept { return static_cast<uint32_t>(c); }
+static_assert(code(Cell::Empty) == EMPTY && code(Cell::Black) == OWN && code(Cell::White) == OTHER
+    && code(Cell::Wall) == WALL);
+
+constexpr uint32_t cellAt(uint32_t window, int k) noexcept { return (window >> (2 * k)) & 3u; }
+constexpr uint32_t withCell(uint32_t window, int k, uint32_t c) noexcept
+{
+    return (window & ~(3u << (2 * k))) | (c << (2 * k));
+}
+
+// Exchanges Black and White (walls and empties are unchanged)
+constexpr uint32_t swapColors(uint32_t window) noexcept
+{
+    return ((window & 0x55555555u) << 1) | ((window >> 1) & 0x55555555u);
+}
+// Window seen from 'who': OWN = who's stones, OTHER = opponent's
+constexpr uint32_t relative(uint32_t window, Cell who) noexcept
+{
+    return who == Cell::White ? swapColors(window) : window;
+}
+
+// Shape flags
+inline constexpr uint8_t FIVE = 1 << 0; // 5 in a row
+inline constexpr uint8_t FOUR = 1 << 1; // 4 of 5 cells + one empty: one move from five
+inline constexpr uint8_t OPEN_FOUR = 1 << 2; // _XXXX_
+inline constexpr uint8_t OPEN_THREE = 1 << 3; // _XXX__, __XXX_, _XX_X_, _X_XX_
+
+// 5-cell windows (10 bits): FIVE / FOUR
+constexpr std::array<uint8_t, 1u << 10> makeShape5()
+{
+    std::array<uint8_t, 1u << 10> t {};
+    for (uint32_t w = 0; w < t.size(); ++w) {
+        int own = 0, empty = 0;
+        for (int k = 0; k < 5; ++k) {
+            own += cellAt(w, k) == OWN;
+            empty += cellAt(w, k) == EMPTY;
+        }
+        if (own == 5)
+            t[w] |= FIVE;
+        else if (own == 4 && empty == 1)
+            t[w] |= FOUR;
+    }
+    return t;
+}
+
+// 6-cell windows (12 bits): OPEN_FOUR / OPEN_THREE (both ends empty, interior decides)
+constexpr std::array<uint8_t, 1u << 12> makeShape6()
+{
+    std::array<uint8_t, 1u << 12> t {};
+    for (uint32_t w = 0; w < t.size(); ++w) {
+        if (cellAt(w, 0) != EMPTY || cellAt(w, 5) != EMPTY)
+            continue;
+        int own = 0, empty = 0;
+        for (int k = 1; k <= 4; ++k) {
+            own += cellAt(w, k) == OWN;
+            empty += cellAt(w, k) == EMPTY;
+        }
+        if (own == 4)
+            t[w] |= OPEN_FOUR;
+        else if (own == 3 && empty == 1)
+            t[w] |= OPEN_THREE;
+    }
+    return t;
+}
+
+inline constexpr auto shape5 = makeShape5();
+inline constexpr auto shape6 = makeShape6();
+
+} // namespace gomoku::shapes
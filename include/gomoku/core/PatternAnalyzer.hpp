@@ -1,22 +1,59 @@
 #pragma once
 
 #include "gomoku/core/BoardState.hpp"
+#include "gomoku/core/CaptureEngine.hpp"
 #include "gomoku/core/Types.hpp"
 
-namespace gomoku::pattern {
+namespace gomoku::inline GOMOKU_SIZE_NS::pattern {
 
 // Returns true if move m would illegally create a double-three for the player, accounting for virtual captures.
 bool createsIllegalDoubleThree(const BoardState& state, Move m, const RuleSet& rules);
 
+// Kernel: does m create two free threes (virtual captures applied)? Ignores the rule flags.
+bool formsDoubleThree(const BoardState& state, Move m) noexcept;
+
+// Free three through m along direction d once m is played (virtual captures applied), read
+// from the 3^9 window table. formsFreeThreeScan is the pattern scan the table is built from
+// (reference for tests).
+bool formsFreeThree(const BoardState& state, Move m, int d) noexcept;
+bool formsFreeThreeScan(const BoardState& state, Move m, int d) noexcept;
+
+// Policy version (see RulePolicy.hpp): flags resolved at compile time.
+template <class P>
+bool createsIllegalDoubleThree(const BoardState& state, Move m) noexcept
+{
+    if constexpr (!P::forbidDoubleThree) {
+        return false;
+    } else {
+        // Exception : un coup capturant est autorisé même s'il crée un double-trois
+        if constexpr (P::captures)
+            if (capture::wouldCapture(state, m))
+                return false;
+        return formsDoubleThree(state, m);
+    }
+}
+
+// Shape flags (shapes::FIVE, FOUR, OPEN_FOUR, OPEN_THREE) that 'who' gets on the line through p
+// in direction d once a stone of 'who' stands on p. Only shapes containing p are reported.
+uint8_t shapesThrough(const BoardState& state, Pos p, int d, Cell who) noexcept;
+
 // Returns true if there are 5 or more stones of 'who' aligned including position p.
 bool checkFiveOrMoreFrom(const BoardState& state, Pos p, Cell who);
 
 // Returns true if there exists anywhere on the board a 5+ line for 'who'.
+// O(1): reads the five-line masks maintained by BoardState.
 bool hasAnyFive(const BoardState& state, Cell who);
 
+// Would 'who' still have a 5+ line once the n stones in 'removed' are taken off?
+// Only the lines currently holding a five are re-checked; state is not modified.
+bool hasFiveAfterRemoving(const BoardState& state, Cell who, const Pos* removed, int n) noexcept;
+
 // After player 'justPlayed' placed a stone and captures were applied, can the opponent immediately
 // break the five-plus line by a capturing move? Also returns true if opponent can immediately
 // win by capture (reach captureWinPairs).
 bool isFiveBreakableNow(const BoardState& state, Player justPlayed, const RuleSet& rules);
 
+// Kernel of isFiveBreakableNow for callers that already know captures are enabled.
+bool fiveBreakableByCapture(const BoardState& state, Player justPlayed, int captureWinPairs);
+
 } // namespace gomoku::pattern
@@ -4,7 +4,10 @@
 #include <array>
 #include <cstdint>
 
-namespace gomoku::rays {
+namespace gomoku::inline GOMOKU_SIZE_NS::rays {
+
+// Sentinelle : case hors plateau
+inline constexpr uint16_t NONE = 0xFFFF;
 
 struct CapRay {
     uint16_t fwd[3] {};
@@ -15,7 +18,7 @@ constexpr uint16_t encode(int x, int y)
 {
     return (unsigned)x < BOARD_SIZE && (unsigned)y < BOARD_SIZE
         ? static_cast<uint16_t>(y * BOARD_SIZE + x)
-        : static_cast<uint16_t>(0xFFFF);
+        : NONE;
 }
 
 constexpr std::array<std::array<CapRay, BOARD_SIZE * BOARD_SIZE>, 4> makeCapRays()
@@ -40,4 +43,40 @@ constexpr std::array<std::array<CapRay, BOARD_SIZE * BOARD_SIZE>, 4> makeCapRays
 // Inline variable (since C++17) to provide a single definition across TUs
 inline constexpr auto capRaysByDir = makeCapRays();
 
+// Voisinage complet le long d'une direction (±NBR_RADIUS), même convention que capRays :
+// fwd[k-1] = case à +k pas, bwd[k-1] = case à -k pas, NONE au-delà du bord.
+// fwdLen/bwdLen = nombre de voisins sur le plateau : les boucles "for k < len" n'ont aucun test de bord.
+inline constexpr int NBR_RADIUS = 5;
+
+struct LineNbr {
+    uint16_t fwd[NBR_RADIUS] {};
+    uint16_t bwd[NBR_RADIUS] {};
+    uint8_t fwdLen { 0 };
+    uint8_t bwdLen { 0 };
+};
+
+constexpr std::array<std::array<LineNbr, BOARD_SIZE * BOARD_SIZE>, 4> makeLineNbrs()
+{
+    std::array<std::array<LineNbr, BOARD_SIZE * BOARD_SIZE>, 4> nbrs {};
+    constexpr int DX[4] = { 1, 0, 1, 1 };
+    constexpr int DY[4] = { 0, 1, 1, -1 };
+    for (int y = 0; y < BOARD_SIZE; ++y) {
+        for (int x = 0; x < BOARD_SIZE; ++x) {
+            const int i = y * BOARD_SIZE + x;
+            for (int d = 0; d < 4; ++d) {
+                LineNbr& n = nbrs[d][i];
+                for (int k = 1; k <= NBR_RADIUS; ++k) {
+                    n.fwd[k - 1] = encode(x + k * DX[d], y + k * DY[d]);
+                    n.bwd[k - 1] = encode(x - k * DX[d], y - k * DY[d]);
+                    n.fwdLen = static_cast<uint8_t>(n.fwdLen + (n.fwd[k - 1] != NONE));
+                    n.bwdLen = static_cast<uint8_t>(n.bwdLen + (n.bwd[k - 1] != NONE));
+                }
+            }
+        }
+    }
+    return nbrs;
+}
+
+inline constexpr auto lineNbrByDir = makeLineNbrs();
+
 } // namespace gomoku::rays
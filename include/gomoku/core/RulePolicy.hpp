@@ -0,0 +1,49 @@
+#pragma once
+
+#include "gomoku/core/Types.hpp"
+
+// Compile-time rule variants. Hot kernels (Board move application, capture and pattern
+// checks) are instantiated per policy, so a variant never re-tests RuleSet flags in its
+// inner loops; withPolicy() maps a runtime RuleSet to its policy with a single switch.
+namespace gomoku::inline GOMOKU_SIZE_NS::rules {
+
+template <bool Captures, bool ForbidDoubleThree, bool FiveOrMore>
+struct Policy {
+    static constexpr bool captures = Captures;
+    static constexpr bool forbidDoubleThree = ForbidDoubleThree;
+    static constexpr bool fiveOrMore = FiveOrMore;
+};
+
+using Standard = Policy<true, true, true>; // règles 42 : captures, double-trois interdit
+using Freestyle = Policy<false, false, true>; // gomoku libre, sans capture
+
+constexpr int policyIndex(const RuleSet& r) noexcept
+{
+    return (r.capturesEnabled ? 1 : 0) | (r.forbidDoubleThree ? 2 : 0) | (r.allowFiveOrMore ? 4 : 0);
+}
+
+// Calls f(Policy<...>{}) with the policy matching r (every flag combination is covered)
+template <class F>
+decltype(auto) withPolicy(const RuleSet& r, F&& f)
+{
+    switch (policyIndex(r)) {
+    case 0:
+        return f(Policy<false, false, false> {});
+    case 1:
+        return f(Policy<true, false, false> {});
+    case 2:
+        return f(Policy<false, true, false> {});
+    case 3:
+        return f(Policy<true, true, false> {});
+    case 4:
+        return f(Policy<false, false, true> {});
+    case 5:
+        return f(Policy<true, false, true> {});
+    case 6:
+        return f(Policy<false, true, true> {});
+    default:
+        return f(Policy<true, true, true> {});
+    }
+}
+
+} // namespace gomoku::rules
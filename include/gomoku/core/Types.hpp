@@ -8,10 +8,22 @@
 #include <utility>
 #include <vector>
 
-namespace gomoku {
+// Board size (19x19 standard Gomoku). Fixed at compile time: libgomoku_logic.a carries
+// one build per supported size (-DGOMOKU_BOARD_SIZE=15 for the 15x15 instantiation).
+#ifndef GOMOKU_BOARD_SIZE
+#define GOMOKU_BOARD_SIZE 19
+#endif
 
-// Board size (19x19 standard Gomoku)
-inline constexpr int BOARD_SIZE = 19;
+// Each size lives in its own inline namespace (gomoku::size19, gomoku::size15) so both
+// instantiations link side by side; code naming gomoku::Board gets the one it was built for.
+#define GOMOKU_SIZE_NS_CAT2(n) size##n
+#define GOMOKU_SIZE_NS_CAT(n) GOMOKU_SIZE_NS_CAT2(n)
+#define GOMOKU_SIZE_NS GOMOKU_SIZE_NS_CAT(GOMOKU_BOARD_SIZE)
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+inline constexpr int BOARD_SIZE = GOMOKU_BOARD_SIZE;
+static_assert(BOARD_SIZE >= 5 && BOARD_SIZE <= 32, "board must hold a five and fit 32-bit line words");
 
 // Represents a player in the game
 enum class Player : uint8_t {
@@ -23,7 +35,8 @@ enum class Player : uint8_t {
 enum class Cell : uint8_t {
     Empty, // Empty cell
     Black, // Cell occupied by black stone
-    White // Cell occupied by white stone
+    White, // Cell occupied by white stone
+    Wall // Off-board sentinel (padded storage border); never placed on the board
 };
 
 // Utility functions for Player <-> Cell conversion
@@ -47,7 +60,7 @@ constexpr Player opponent(Player p) noexcept
 
 // Position on the game board (0-based coordinates)
 struct Pos {
-    uint8_t x { 0 }, y { 0 }; // 0..18
+    uint8_t x { 0 }, y { 0 }; // 0..BOARD_SIZE-1
 
     // Equality comparison
     constexpr bool operator==(const Pos& other) const noexcept { return x == other.x && y == other.y; }
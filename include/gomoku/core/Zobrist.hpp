@@ -1,13 +1,63 @@
 #pragma once
 #include "gomoku/core/Types.hpp"
+#include <array>
 #include <cstdint>
 
-namespace gomoku::zobrist {
+namespace gomoku::inline GOMOKU_SIZE_NS::zobrist {
 
 using FlatIdx = uint16_t;
 
+namespace detail {
+    inline constexpr std::size_t S = static_cast<std::size_t>(BOARD_SIZE) * BOARD_SIZE;
+    // Compteurs de paires au-delà : même clé (le hash reste cohérent, seules ces positions se confondent)
+    inline constexpr int PAIR_SLOTS = 64;
+    inline constexpr uint64_t DEFAULT_SEED = 0x9E3779B97F4A7C15ULL;
+
+    struct Keys {
+        std::array<uint64_t, 2 * S> pieces {};
+        std::array<std::array<uint64_t, PAIR_SLOTS>, 2> pairs {}; // pairs[c][0] == 0
+        std::array<uint64_t, 4> status {}; // status[Ongoing] == 0
+        static_assert(static_cast<int>(GameStatus::Draw) == 3, "one status key per GameStatus");
+        uint64_t side { 0 };
+    };
+
+    constexpr uint64_t splitmix64(uint64_t& s) noexcept
+    {
+        uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Généré à la compilation : aucun travail au démarrage
+    constexpr Keys makeKeys(uint64_t seed) noexcept
+    {
+        Keys k {};
+        for (auto& v : k.pieces)
+            v = splitmix64(seed);
+        for (auto& perColor : k.pairs)
+            for (std::size_t n = 1; n < perColor.size(); ++n)
+                perColor[n] = splitmix64(seed);
+        for (std::size_t s = 1; s < k.status.size(); ++s)
+            k.status[s] = splitmix64(seed);
+        k.side = splitmix64(seed);
+        return k;
+    }
+
+    inline constexpr Keys defaultKeys = makeKeys(DEFAULT_SEED);
+    // Copie modifiable (reseed) initialisée statiquement
+    inline constinit Keys keys = defaultKeys;
+} // namespace detail
+
 // Zobrist key pour (c, index linéaire).
-uint64_t piece(Cell c, FlatIdx idx) noexcept;
+inline uint64_t piece(Cell c, FlatIdx idx) noexcept
+{
+    // Empty -> 0
+    if (c == Cell::Empty)
+        return 0ull;
+    const std::size_t color = (c == Cell::White) ? 1 : 0;
+    return detail::keys.pieces[color * detail::S + idx];
+}
 
 // Surcharges de confort (délèguent à la version FlatIdx)
 inline uint64_t piece(Cell c, uint8_t x, uint8_t y) noexcept
@@ -20,9 +70,33 @@ inline uint64_t piece(Cell c, Pos p) noexcept
 }
 
 // Side-to-move toggle (à XOR à chaque changement de trait).
-uint64_t side() noexcept;
+inline uint64_t side() noexcept { return detail::keys.side; }
+
+// Clé du compteur de paires capturées par c (0 pour 0 paire).
+inline uint64_t pairs(Cell c, int count) noexcept
+{
+    const std::size_t color = (c == Cell::White) ? 1 : 0;
+    const int slot = count < detail::PAIR_SLOTS ? count : detail::PAIR_SLOTS - 1;
+    return detail::keys.pairs[color][static_cast<std::size_t>(slot)];
+}
+
+// Clé du statut de partie (0 pour Ongoing).
+inline uint64_t status(GameStatus s) noexcept
+{
+    return detail::keys.status[static_cast<std::size_t>(s)];
+}
+
+// Clé du jeu de règles, à combiner (XOR) avec la clé de position quand une TT est partagée
+// entre parties aux règles différentes (mêmes pierres, coups légaux et scores différents).
+inline uint64_t rules(const RuleSet& r) noexcept
+{
+    uint64_t s = detail::keys.side
+        ^ (static_cast<uint64_t>(r.forbidDoubleThree) | (static_cast<uint64_t>(r.allowFiveOrMore) << 1)
+            | (static_cast<uint64_t>(r.capturesEnabled) << 2) | (static_cast<uint64_t>(r.captureWinPairs) << 8));
+    return detail::splitmix64(s);
+}
 
-// Initialize Zobrist tables (called automatically, but can be called explicitly for tests)
+// Restore the default (compile-time) tables, e.g. after reseed() in tests
 void init() noexcept;
 
 // (Optionnel) pour tests : redéfinir les clés de façon déterministe
@@ -4,7 +4,7 @@
 #include <optional>
 #include <vector>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 class IBoardView {
 public:
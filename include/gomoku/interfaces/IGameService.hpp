@@ -4,7 +4,7 @@
 #include <optional>
 #include <string>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 /**
  * Interface for game orchestration and business logic
@@ -1,10 +1,11 @@
 #pragma once
 #include "gomoku/ai/SearchStats.hpp"
+#include "gomoku/ai/TimeManager.hpp"
 #include "gomoku/core/Types.hpp"
 #include "gomoku/interfaces/IBoardView.hpp"
 #include <optional>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 /**
  * Interface for AI/MinimaxSearch engine capabilities
@@ -20,6 +21,9 @@ public:
     virtual void setTimeLimit(int milliseconds) = 0;
     virtual void setDepthLimit(int maxDepth) = 0;
     virtual void setTranspositionTableSize(size_t bytes) = 0;
+    virtual void setThreadCount(int threads) = 0; // Lazy SMP: 1 = single-threaded
+    virtual void setGameClock(const GameClock& clock) = 0; // remaining time of the side to move
+    virtual void setNodeBudget(unsigned long long nodes) = 0; // > 0: node budget mode, clock ignored
 
     // MinimaxSearch operations
     virtual std::optional<Move> findBestMove(
@@ -35,6 +39,16 @@ public:
         SearchStats* stats = nullptr)
         = 0;
 
+    // Thread-safe: aborts the search running in another thread, which then returns the
+    // best move of its completed part
+    virtual void stop() = 0;
+
+    // Pondering: search `board` (position after the expected reply) on the opponent's time.
+    // ponderHit() turns it into the timed search of that position; stopPondering() drops it.
+    virtual void startPondering(const IBoardView& board, const RuleSet& rules) = 0;
+    virtual std::optional<Move> ponderHit(int timeMs, SearchStats* stats = nullptr) = 0;
+    virtual void stopPondering() = 0;
+
     // Analysis
     virtual int evaluatePosition(const IBoardView& board, Player perspective) const = 0;
     virtual std::vector<Move> getOrderedMoves(const IBoardView& board, const RuleSet& rules) const = 0;
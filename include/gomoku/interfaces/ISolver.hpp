@@ -0,0 +1,47 @@
+#pragma once
+#include "gomoku/core/Types.hpp"
+#include "gomoku/interfaces/IBoardView.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+// Game-theoretic value of a position for the side to move
+enum class ProofValue : uint8_t {
+    Unknown, // no proof within the limits
+    Win, // the side to move forces a win
+    Loss // the opponent forces a win whatever the side to move plays
+};
+
+struct ProofResult {
+    ProofValue value = ProofValue::Unknown;
+    std::vector<Move> line; // winner's moves and the longest defence, up to the winning move
+    long long nodes = 0;
+    int timeMs = 0;
+};
+
+/**
+ * Interface for exact solvers (analysis backend)
+ *
+ * Sibling of ISearchEngine: a solver does not score positions, it proves them
+ * won or lost, or gives up within its node, time and memory limits.
+ */
+class ISolver {
+public:
+    virtual ~ISolver() = default;
+
+    // Limits (0 = none for nodes and time)
+    virtual void setNodeLimit(unsigned long long nodes) = 0;
+    virtual void setTimeLimit(int milliseconds) = 0;
+    virtual void setMemoryLimit(std::size_t bytes) = 0;
+
+    virtual ProofResult solve(const IBoardView& board, const RuleSet& rules) = 0;
+
+    // Thread-safe: a running solve() returns Unknown
+    virtual void stop() = 0;
+    // Frees the solver tables (allocated again by the next solve)
+    virtual void clear() = 0;
+};
+
+} // namespace gomoku
@@ -1,11 +1,12 @@
 // gomoku/ai/CandidateGenerator.cpp
 #include "gomoku/ai/CandidateGenerator.hpp"
+#include "gomoku/core/RayTables.hpp"
 #include "util/Logger.hpp"
 #include <algorithm>
 #include <array>
-#include <bitset>
+#include <bit>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 namespace {
 
@@ -19,12 +20,6 @@ namespace {
         uint8_t x, y;
     };
 
-    constexpr int BOARD_CELLS = BOARD_SIZE * BOARD_SIZE;
-
-    inline bool inside(int x, int y)
-    {
-        return 0 <= x && x < BOARD_SIZE && 0 <= y && y < BOARD_SIZE;
-    }
     inline bool intersect(const Rect& a, const Rect& b)
     {
         return !(a.x2 < b.x1 || b.x2 < a.x1 || a.y2 < b.y1 || b.y2 < a.y1);
@@ -132,14 +127,13 @@ namespace {
     //-------------------------------------------
     // Étape 3 — Masque O(1) des zones actives
     //-------------------------------------------
-    using ActiveMask = std::array<uint8_t, BOARD_CELLS>;
-    ActiveMask buildActiveMask(const std::vector<Rect>& rects)
+    // Une ligne de rectangle = une plage de bits contiguë (remplie mot par mot)
+    Bitboard buildActiveMask(const std::vector<Rect>& rects)
     {
-        ActiveMask active {}; // zéro-initialisé
+        Bitboard active;
         for (const auto& r : rects)
             for (int y = r.y1; y <= r.y2; ++y)
-                for (int x = r.x1; x <= r.x2; ++x)
-                    active[y * BOARD_SIZE + x] = 1;
+                active.setRange(y * BOARD_SIZE + r.x1, y * BOARD_SIZE + r.x2);
         return active;
     }
 
@@ -169,40 +163,32 @@ namespace {
     }
 
     //-------------------------------------------
-    // Déduplication (bitset compact)
+    // Déduplication : 'avail' = cases actives, vides et pas encore émises.
+    // Un seul test de bit remplace masque actif + case vide + bitset "seen".
     //-------------------------------------------
-    using SeenSet = std::bitset<BOARD_CELLS>;
-    inline bool markIfNew(SeenSet& seen, int x, int y)
+    inline bool takeIfAvailable(Bitboard& avail, int i)
     {
-        const int i = y * BOARD_SIZE + x;
-        if (seen.test(i))
+        if (!avail.test(i))
             return false;
-        seen.set(i);
+        avail.reset(i);
         return true;
     }
 
     //-------------------------------------------
     // Étape 5 — Émission des candidats par anneaux
     //-------------------------------------------
-    void emitNeighborhood(const Board& b,
-        const ActiveMask& active,
-        const std::vector<Offset>& ring,
+    void emitNeighborhood(const std::vector<Offset>& ring,
         uint8_t cx, uint8_t cy,
         Player toPlay,
         uint16_t maxCandidates,
-        SeenSet& seen,
+        Bitboard& avail,
         std::vector<Move>& out)
     {
         for (auto [dx, dy] : ring) {
             int x = (int)cx + dx, y = (int)cy + dy;
             if ((unsigned)x >= BOARD_SIZE || (unsigned)y >= BOARD_SIZE)
                 continue;
-            int idx = y * BOARD_SIZE + x;
-            if (!active[idx])
-                continue; // clamp O(1)
-            if (b.at((uint8_t)x, (uint8_t)y) != Cell::Empty)
-                continue;
-            if (!markIfNew(seen, x, y))
+            if (!takeIfAvailable(avail, y * BOARD_SIZE + x))
                 continue;
             out.push_back(Move { { (uint8_t)x, (uint8_t)y }, toPlay });
             if (out.size() >= maxCandidates)
@@ -212,10 +198,9 @@ namespace {
 
     void generateFromRings(const Board& b,
         const std::vector<P>& stones,
-        const ActiveMask& active,
         Player toPlay,
         const CandidateConfig& cfg,
-        SeenSet& seen,
+        Bitboard& avail,
         std::vector<Move>& out)
     {
         const auto& ring = diamondOffsets(cfg.ringR);
@@ -224,7 +209,7 @@ namespace {
         size_t stonesProcessed = 0;
         if (cfg.includeOpponentRing) {
             for (const auto& p : stones) {
-                emitNeighborhood(b, active, ring, p.x, p.y, toPlay, cfg.maxCandidates, seen, out);
+                emitNeighborhood(ring, p.x, p.y, toPlay, cfg.maxCandidates, avail, out);
                 stonesProcessed++;
                 if (out.size() >= cfg.maxCandidates)
                     break;
@@ -234,7 +219,7 @@ namespace {
             for (const auto& p : stones) {
                 if (b.at(p.x, p.y) != mine)
                     continue;
-                emitNeighborhood(b, active, ring, p.x, p.y, toPlay, cfg.maxCandidates, seen, out);
+                emitNeighborhood(ring, p.x, p.y, toPlay, cfg.maxCandidates, avail, out);
                 stonesProcessed++;
                 if (out.size() >= cfg.maxCandidates)
                     break;
@@ -245,22 +230,16 @@ namespace {
     //-------------------------------------------
     // Étape 6 — Fallback scan des rectangles
     //-------------------------------------------
-    void fallbackScan(const Board& b,
-        const std::vector<Rect>& rects,
-        const ActiveMask& active,
+    void fallbackScan(const std::vector<Rect>& rects,
         Player toPlay,
         const CandidateConfig& cfg,
-        SeenSet& seen,
+        Bitboard& avail,
         std::vector<Move>& out)
     {
         for (const auto& r : rects) {
             for (int y = r.y1; y <= r.y2; ++y)
                 for (int x = r.x1; x <= r.x2; ++x) {
-                    if (b.at((uint8_t)x, (uint8_t)y) != Cell::Empty)
-                        continue;
-                    if (!active[y * BOARD_SIZE + x])
-                        continue; // cohérence
-                    if (!markIfNew(seen, x, y))
+                    if (!takeIfAvailable(avail, y * BOARD_SIZE + x))
                         continue;
                     out.push_back(Move { { (uint8_t)x, (uint8_t)y }, toPlay });
                     if (out.size() >= cfg.maxCandidates)
@@ -314,21 +293,17 @@ std::vector<Move> CandidateGenerator::generate(const Board& b, const RuleSet& ru
     const int effMargin = std::max<int>(cfg.margin, cfg.ringR);
     rects = dilateAndMerge(std::move(rects), effMargin);
 
-    // 3) Masque des zones actives
-    ActiveMask active = buildActiveMask(rects);
-    int activeCells = 0;
-    for (int i = 0; i < BOARD_CELLS; ++i) {
-        if (active[i])
-            activeCells++;
-    }
+    // 3) Masque des zones actives, privé des cases occupées
+    Bitboard avail = buildActiveMask(rects);
+    avail.andNot(b.rawState().occupancy());
+
     // 4–5) Anneaux (Manhattan <= ringR) clampés par masque + dédup bitset
-    SeenSet seen;
     std::vector<Move> out;
-    generateFromRings(b, stones, active, toPlay, cfg, seen, out);
+    generateFromRings(b, stones, toPlay, cfg, avail, out);
 
     // 6) Fallback scan si densité insuffisante
     if (out.size() < 12) {
-        fallbackScan(b, rects, active, toPlay, cfg, seen, out);
+        fallbackScan(rects, toPlay, cfg, avail, out);
     }
 
     // 7) Finalisation
@@ -341,93 +316,51 @@ std::vector<Move> CandidateGenerator::generateTactical(const Board& b, const Rul
 {
     std::vector<Move> moves;
     moves.reserve(64);
-    SeenSet seen; // bitset to avoid duplicates
+    Bitboard seen; // bitset to avoid duplicates
 
+    const BoardState& st = b.rawState();
     const auto& occ = b.occupiedPositions();
     const Cell me = (toPlay == Player::Black) ? Cell::Black : Cell::White;
     const Cell opp = (toPlay == Player::Black) ? Cell::White : Cell::Black;
 
-    auto add = [&](int x, int y) {
-        if (inside(x, y) && markIfNew(seen, x, y)) {
-            if (b.at((uint8_t)x, (uint8_t)y) == Cell::Empty) {
-                moves.push_back(Move { Pos { (uint8_t)x, (uint8_t)y }, toPlay });
-            }
+    auto add = [&](int id) {
+        if (!seen.test(id)) {
+            seen.set(id);
+            moves.push_back(Move { Pos::fromIndex(static_cast<uint16_t>(id)), toPlay });
         }
     };
 
-    // Directions: E, S, SE, SW
-    constexpr int dx[] = { 1, 0, 1, 1 };
-    constexpr int dy[] = { 0, 1, 1, -1 };
-
     for (const auto& p : occ) {
-        int x = p.x;
-        int y = p.y;
-        Cell c = b.at((uint8_t)x, (uint8_t)y);
+        const Cell c = st.getCell(p);
+        const int pi = BoardState::idx(p);
 
         for (int d = 0; d < 4; ++d) {
+            const auto& nb = rays::lineNbrByDir[d][pi]; // cells at +k / -k, k >= 1
+            const lines::Coord lc = lines::coords[d][pi];
+            const int bit = lc.bit;
+            const uint32_t C = st.lineBits(c, d, lc.line);
+            const uint32_t E = st.lineEmpty(d, lc.line);
+            const uint32_t V = lines::valid[d][lc.line];
+
             // 1. Captures: X O O _ (we are X, looking for _)
             if (c == me) {
+                const uint32_t O = st.lineBits(opp, d, lc.line);
                 // Check forward: X O O ?
-                if (inside(x + 3 * dx[d], y + 3 * dy[d])) {
-                    if (b.at((uint8_t)(x + dx[d]), (uint8_t)(y + dy[d])) == opp && b.at((uint8_t)(x + 2 * dx[d]), (uint8_t)(y + 2 * dy[d])) == opp && b.at((uint8_t)(x + 3 * dx[d]), (uint8_t)(y + 3 * dy[d])) == Cell::Empty) {
-                        add(x + 3 * dx[d], y + 3 * dy[d]);
-                    }
-                }
+                if (lines::test(O, bit + 1) && lines::test(O, bit + 2) && lines::test(E, bit + 3))
+                    add(nb.fwd[2]);
                 // Check backward: ? O O X
-                if (inside(x - 3 * dx[d], y - 3 * dy[d])) {
-                    if (b.at((uint8_t)(x - dx[d]), (uint8_t)(y - dy[d])) == opp && b.at((uint8_t)(x - 2 * dx[d]), (uint8_t)(y - 2 * dy[d])) == opp && b.at((uint8_t)(x - 3 * dx[d]), (uint8_t)(y - 3 * dy[d])) == Cell::Empty) {
-                        add(x - 3 * dx[d], y - 3 * dy[d]);
-                    }
-                }
+                if (lines::test(O, bit - 1) && lines::test(O, bit - 2) && lines::test(E, bit - 3))
+                    add(nb.bwd[2]);
             }
 
-            // 2. Threats (4 or 5)
-            // Check window of 4 cells (for 3 stones -> potential 4)
-            if (inside(x + 3 * dx[d], y + 3 * dy[d])) {
-                Cell c1 = b.at((uint8_t)x, (uint8_t)y);
-                Cell c2 = b.at((uint8_t)(x + dx[d]), (uint8_t)(y + dy[d]));
-                Cell c3 = b.at((uint8_t)(x + 2 * dx[d]), (uint8_t)(y + 2 * dy[d]));
-                Cell c4 = b.at((uint8_t)(x + 3 * dx[d]), (uint8_t)(y + 3 * dy[d]));
-
-                int cnt = (c1 == c) + (c2 == c) + (c3 == c) + (c4 == c);
-                int empty = (c1 == Cell::Empty) + (c2 == Cell::Empty) + (c3 == Cell::Empty) + (c4 == Cell::Empty);
-
-                if (cnt == 3 && empty == 1) {
-                    if (c1 == Cell::Empty)
-                        add(x, y);
-                    if (c2 == Cell::Empty)
-                        add(x + dx[d], y + dy[d]);
-                    if (c3 == Cell::Empty)
-                        add(x + 2 * dx[d], y + 2 * dy[d]);
-                    if (c4 == Cell::Empty)
-                        add(x + 3 * dx[d], y + 3 * dy[d]);
-                }
-            }
+            // 2. Threats (4 or 5): windows starting at the stone, 'c' stones + exactly one empty
+            // Window of 4 cells (3 stones -> potential 4)
+            if (lines::test(V, bit + 3) && lines::countIn(C, bit, 4) == 3 && lines::countIn(E, bit, 4) == 1)
+                add(nb.fwd[std::countr_zero((E >> bit) & 0xFu) - 1]);
 
-            // Check window of 5 cells (for 4 stones -> potential 5)
-            if (inside(x + 4 * dx[d], y + 4 * dy[d])) {
-                Cell c1 = b.at((uint8_t)x, (uint8_t)y);
-                Cell c2 = b.at((uint8_t)(x + dx[d]), (uint8_t)(y + dy[d]));
-                Cell c3 = b.at((uint8_t)(x + 2 * dx[d]), (uint8_t)(y + 2 * dy[d]));
-                Cell c4 = b.at((uint8_t)(x + 3 * dx[d]), (uint8_t)(y + 3 * dy[d]));
-                Cell c5 = b.at((uint8_t)(x + 4 * dx[d]), (uint8_t)(y + 4 * dy[d]));
-
-                int cnt = (c1 == c) + (c2 == c) + (c3 == c) + (c4 == c) + (c5 == c);
-                int empty = (c1 == Cell::Empty) + (c2 == Cell::Empty) + (c3 == Cell::Empty) + (c4 == Cell::Empty) + (c5 == Cell::Empty);
-
-                if (cnt == 4 && empty == 1) {
-                    if (c1 == Cell::Empty)
-                        add(x, y);
-                    if (c2 == Cell::Empty)
-                        add(x + dx[d], y + dy[d]);
-                    if (c3 == Cell::Empty)
-                        add(x + 2 * dx[d], y + 2 * dy[d]);
-                    if (c4 == Cell::Empty)
-                        add(x + 3 * dx[d], y + 3 * dy[d]);
-                    if (c5 == Cell::Empty)
-                        add(x + 4 * dx[d], y + 4 * dy[d]);
-                }
-            }
+            // Window of 5 cells (4 stones -> potential 5)
+            if (lines::test(V, bit + 4) && lines::countIn(C, bit, 5) == 4 && lines::countIn(E, bit, 5) == 1)
+                add(nb.fwd[std::countr_zero((E >> bit) & 0x1Fu) - 1]);
         }
     }
 
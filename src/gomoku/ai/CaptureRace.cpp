@@ -0,0 +1,321 @@
+// CaptureRace.cpp - Exact capture-race solver used as an oracle by negamax
+#include "gomoku/ai/CaptureRace.hpp"
+#include "gomoku/ai/SearchHelpers.hpp"
+#include "gomoku/core/Bitboard.hpp"
+#include "gomoku/core/Board.hpp"
+#include "gomoku/core/CaptureEngine.hpp"
+#include "gomoku/core/RayTables.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+namespace {
+    constexpr int FIVE_REACH = 2; // une pierre posée à 2 cases d'un cinq peut rendre une de ses paires capturable
+    constexpr uint32_t WINDOW5 = 0x1Fu;
+
+    inline Cell cellAt(const BoardState& st, uint16_t i) noexcept
+    {
+        return i == rays::NONE ? Cell::Wall : st.getCell(Pos::fromIndex(i));
+    }
+
+    inline Cell other(Cell c) noexcept
+    {
+        return c == Cell::Black ? Cell::White : Cell::Black;
+    }
+
+    // Empty cells where a stone of 'who' captures: the neighbours of the opponent's stones
+    // that capture::wouldCapture accepts
+    Bitboard captureMoves(const Board& board, Player who)
+    {
+        const BoardState& st = board.rawState();
+        const Cell opp = other(playerToCell(who));
+        Bitboard tried, out;
+        for (const Pos& p : board.occupiedPositions()) {
+            if (st.getCell(p) != opp)
+                continue;
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const int x = p.x + dx, y = p.y + dy;
+                    if ((dx == 0 && dy == 0) || x < 0 || y < 0 || x >= BOARD_SIZE || y >= BOARD_SIZE)
+                        continue;
+                    const uint16_t i = BoardState::idx(static_cast<uint8_t>(x), static_cast<uint8_t>(y));
+                    if (tried.test(i) || st.getCell(Pos::fromIndex(i)) != Cell::Empty)
+                        continue;
+                    tried.set(i);
+                    if (capture::wouldCapture(st, Move { Pos::fromIndex(i), who }))
+                        out.set(i);
+                }
+        }
+        return out;
+    }
+
+    // Empty ends of the opponent's open pairs (_ O O _): a stone of 'who' on one end
+    // threatens to capture on the other
+    Bitboard captureThreatMoves(const Board& board, Player who)
+    {
+        const BoardState& st = board.rawState();
+        const Cell opp = other(playerToCell(who));
+        Bitboard out;
+        for (const Pos& p : board.occupiedPositions()) {
+            if (st.getCell(p) != opp)
+                continue;
+            for (int d = 0; d < 4; ++d) {
+                const rays::CapRay& r = rays::capRaysByDir[d][BoardState::idx(p)];
+                if (cellAt(st, r.fwd[0]) == opp && cellAt(st, r.bwd[0]) == Cell::Empty && cellAt(st, r.fwd[1]) == Cell::Empty) {
+                    out.set(r.bwd[0]);
+                    out.set(r.fwd[1]);
+                }
+            }
+        }
+        return out;
+    }
+
+    // Calls f(d, line, window) for each 5-cell window of 'who' holding 'stones' stones and
+    // no opponent stone
+    template <class F>
+    void forEachWindow(const BoardState& st, Cell who, int stones, F&& f)
+    {
+        for (int d = 0; d < lines::DIRS; ++d)
+            for (int line = 0; line < lines::COUNT; ++line) {
+                const uint32_t own = st.lineBits(who, d, line);
+                if (std::popcount(own) < stones)
+                    continue;
+                const uint32_t opp = st.lineBits(other(who), d, line);
+                const uint32_t valid = lines::valid[d][line];
+                for (int s = 0; s + 5 <= BOARD_SIZE; ++s) {
+                    const uint32_t w = WINDOW5 << s;
+                    if ((valid & w) == w && !(opp & w) && std::popcount(own & w) == stones)
+                        f(d, line, w);
+                }
+            }
+    }
+
+    // Empty cells completing a window of 'who' that holds 'stones' stones (4: five, 3: four)
+    Bitboard windowCells(const BoardState& st, Cell who, int stones)
+    {
+        Bitboard out;
+        forEachWindow(st, who, stones, [&](int d, int line, uint32_t w) {
+            for (uint32_t e = w & ~st.lineBits(who, d, line); e; e &= e - 1)
+                out.set(lines::cellIndex(d, line, std::countr_zero(e)));
+        });
+        return out;
+    }
+
+    // Cells within FIVE_REACH of a five that 'who' completes on f: where a defender stone can
+    // turn one of its pairs into a capturable one (D X X _), which makes the five breakable
+    Bitboard fiveRegion(const BoardState& st, Cell who, uint16_t f)
+    {
+        Bitboard out;
+        for (int d = 0; d < lines::DIRS; ++d) {
+            const lines::Coord c = lines::coords[d][f];
+            const uint32_t own = st.lineBits(who, d, c.line);
+            const uint32_t opp = st.lineBits(other(who), d, c.line);
+            const uint32_t valid = lines::valid[d][c.line];
+            for (int s = std::max(0, c.bit - 4); s <= c.bit && s + 5 <= BOARD_SIZE; ++s) {
+                const uint32_t w = WINDOW5 << s;
+                if ((valid & w) != w || (opp & w) || std::popcount(own & w) != 4)
+                    continue;
+                for (uint32_t b = w; b; b &= b - 1) {
+                    const Pos p = Pos::fromIndex(lines::cellIndex(d, c.line, std::countr_zero(b)));
+                    for (int dy = -FIVE_REACH; dy <= FIVE_REACH; ++dy)
+                        for (int dx = -FIVE_REACH; dx <= FIVE_REACH; ++dx) {
+                            const int x = p.x + dx, y = p.y + dy;
+                            if (x >= 0 && y >= 0 && x < BOARD_SIZE && y < BOARD_SIZE)
+                                out.set(BoardState::idx(static_cast<uint8_t>(x), static_cast<uint8_t>(y)));
+                        }
+                }
+            }
+        }
+        return out;
+    }
+
+    std::vector<uint16_t> cellsOf(const Bitboard& b)
+    {
+        std::vector<uint16_t> out;
+        b.forEach([&](uint16_t i) { out.push_back(i); });
+        return out;
+    }
+} // namespace
+
+bool CaptureRace::applies(const Board& board, const RuleSet& rules) const noexcept
+{
+    if (!rules.capturesEnabled || cfg_.pairsThreshold <= 0)
+        return false;
+    const BoardState& st = board.rawState();
+    return std::max(st.blackPairs, st.whitePairs) >= std::min<int>(cfg_.pairsThreshold, rules.captureWinPairs - 1);
+}
+
+CaptureRace::Result CaptureRace::decide(Board& board, const RuleSet& rules, const std::atomic<bool>* stop, long long nodeLimit)
+{
+    if (board.status() != GameStatus::Ongoing)
+        return {};
+    if (cache_.empty())
+        cache_.resize(std::bit_floor(std::max<std::size_t>(cfg_.cacheEntries, 1)));
+
+    const uint64_t key = search::ttKey(board, rules);
+    CacheEntry& slot = cache_[key & (cache_.size() - 1)];
+    if (slot.key == key)
+        return { slot.verdict, slot.plies };
+
+    rules_ = &rules;
+    stop_ = stop;
+    nodes_ = 0;
+    limit_ = nodeLimit > 0 ? std::min(nodeLimit, cfg_.nodeLimit) : cfg_.nodeLimit;
+    aborted_ = false;
+
+    // Approfondissement itératif : le gain (ou la défaite) le plus court
+    Result res;
+    int plies = 0;
+    Outcome out = Outcome::NoWin;
+    for (int depth = 0; depth <= cfg_.maxDepth && out == Outcome::NoWin; ++depth)
+        if ((out = attack(board, depth, plies)) == Outcome::Win)
+            res = { Verdict::Win, plies };
+    // La menace adverse déjà posée compte pour un de ses coups d'attaque
+    if (out == Outcome::NoWin)
+        for (int depth = 0; depth < cfg_.maxDepth && out == Outcome::NoWin; ++depth)
+            if ((out = defend(board, depth, plies)) == Outcome::Win)
+                res = { Verdict::Loss, plies };
+    totalNodes_ += std::min(nodes_, limit_); // le nœud refusé n'est pas exploré
+
+    const bool interrupted = (stop_ && stop_->load(std::memory_order_relaxed)) || (aborted_ && limit_ < cfg_.nodeLimit);
+    if (!interrupted)
+        slot = CacheEntry { key, res.verdict, static_cast<uint8_t>(std::min(res.plies, 255)) };
+    return res;
+}
+
+bool CaptureRace::enterNode()
+{
+    if (aborted_)
+        return false;
+    if (++nodes_ > limit_ || ((nodes_ & 255) == 0 && stop_ && stop_->load(std::memory_order_relaxed)))
+        aborted_ = true;
+    return !aborted_;
+}
+
+std::vector<Move> CaptureRace::immediateWins(Board& board) const
+{
+    const Player me = board.toPlay();
+    const BoardState& st = board.rawState();
+    Bitboard tries = windowCells(st, playerToCell(me), 4);
+    if (st.pairs(playerToCell(me)) + 1 >= rules_->captureWinPairs)
+        captureMoves(board, me).forEach([&](uint16_t i) {
+            capture::CaptureBuffer removed;
+            if (st.pairs(playerToCell(me)) + capture::findCaptures(st, Move { Pos::fromIndex(i), me }, removed) >= rules_->captureWinPairs)
+                tries.set(i);
+        });
+
+    std::vector<Move> wins;
+    tries.forEach([&](uint16_t i) {
+        const Move m { Pos::fromIndex(i), me };
+        if (!board.makeMove(m, *rules_))
+            return;
+        const GameStatus s = board.status();
+        board.unmakeMove();
+        if (s == GameStatus::WinByAlign || s == GameStatus::WinByCapture)
+            wins.push_back(m);
+    });
+    return wins;
+}
+
+std::vector<Move> CaptureRace::threatsAgainst(Board& board) const
+{
+    const Player me = board.toPlay();
+    board.forceSide(opponent(me));
+    std::vector<Move> wins = immediateWins(board);
+    board.forceSide(me);
+    return wins;
+}
+
+CaptureRace::Outcome CaptureRace::attack(Board& board, int depth, int& plies)
+{
+    if (!enterNode())
+        return Outcome::Aborted;
+    if (!immediateWins(board).empty()) {
+        plies = 1;
+        return Outcome::Win;
+    }
+    if (depth <= 0)
+        return Outcome::NoWin;
+
+    const Player me = board.toPlay();
+    const BoardState& st = board.rawState();
+    // Captures d'abord, puis quatres, puis menaces de capture
+    const Bitboard captures = captureMoves(board, me);
+    Bitboard fours = windowCells(st, playerToCell(me), 3);
+    Bitboard threats = captureThreatMoves(board, me);
+    std::vector<uint16_t> order = cellsOf(captures);
+    fours.andNot(captures);
+    for (uint16_t i : cellsOf(fours))
+        order.push_back(i);
+    threats.andNot(captures | fours);
+    for (uint16_t i : cellsOf(threats))
+        order.push_back(i);
+
+    for (uint16_t i : order) {
+        if (!board.makeMove(Move { Pos::fromIndex(i), me }, *rules_))
+            continue;
+        int sub = 0;
+        const Outcome o = defend(board, depth - 1, sub);
+        board.unmakeMove();
+        if (o == Outcome::Win) {
+            plies = 1 + sub;
+            return Outcome::Win;
+        }
+        if (o == Outcome::Aborted)
+            return o;
+    }
+    return Outcome::NoWin;
+}
+
+CaptureRace::Outcome CaptureRace::defend(Board& board, int depth, int& plies)
+{
+    if (!enterNode())
+        return Outcome::Aborted;
+    if (board.status() != GameStatus::Ongoing || !immediateWins(board).empty())
+        return Outcome::NoWin;
+    const std::vector<Move> threats = threatsAgainst(board);
+    if (threats.empty())
+        return Outcome::NoWin; // coup calme : hors du champ du solveur
+
+    // Parades : cases menacées, toutes nos captures, nos cinq (même cassables : l'attaquant
+    // doit alors les casser) ; contre un cinq, les cases qui rendraient une de ses paires
+    // capturable et nos menaces de capture. Tout autre coup laisse la menace intacte.
+    const Player me = board.toPlay();
+    const BoardState& st = board.rawState();
+    const Cell att = other(playerToCell(me));
+    const Bitboard fives = windowCells(st, att, 4);
+    Bitboard replies = captureMoves(board, me) | windowCells(st, playerToCell(me), 4);
+    bool fiveThreat = false;
+    for (const Move& t : threats) {
+        const uint16_t i = t.pos.toIndex();
+        replies.set(i);
+        if (fives.test(i)) {
+            replies |= fiveRegion(st, att, i);
+            fiveThreat = true;
+        }
+    }
+    // Un cinq n'est pas gagnant si l'adversaire peut gagner par capture, n'importe où
+    if (fiveThreat)
+        replies |= captureThreatMoves(board, me);
+    replies.andNot(st.occupancy());
+
+    int worst = 0;
+    bool defended = false;
+    for (uint16_t i : cellsOf(replies)) {
+        if (!board.makeMove(Move { Pos::fromIndex(i), me }, *rules_))
+            continue; // double-trois interdit
+        int sub = 0;
+        const Outcome o = board.status() == GameStatus::Ongoing ? attack(board, depth, sub) : Outcome::NoWin;
+        board.unmakeMove();
+        if (o != Outcome::Win)
+            return o;
+        defended = true;
+        worst = std::max(worst, sub);
+    }
+    // Aucune parade jouable : n'importe quel coup, puis la menace
+    plies = 1 + (defended ? worst : 1);
+    return Outcome::Win;
+}
+
+} // namespace gomoku
@@ -1,61 +1,15 @@
 // Evaluator.cpp - Static position evaluation for Gomoku
 #include "gomoku/ai/Evaluator.hpp"
+#include "gomoku/ai/NnueNetwork.hpp"
 #include "gomoku/core/Board.hpp"
+#include "util/Logger.hpp"
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 
-namespace gomoku::eval {
+namespace gomoku::inline GOMOKU_SIZE_NS::eval {
 
 namespace {
-    // Helpers: Boundary and cell checks (wrappers for Board API with arithmetic-friendly overloads)
-
-    // Check if position is valid - for signed int (used after arithmetic with deltas)
-    inline bool inside(int x, int y) noexcept
-    {
-        return x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE;
-    }
-
-    // Check if cell is empty - for signed int coordinates
-    inline bool isEmpty(const Board& board, int x, int y) noexcept
-    {
-        return inside(x, y) && board.isEmpty(static_cast<uint8_t>(x), static_cast<uint8_t>(y));
-    }
-
-    // Helper: Count empty spaces in a direction from a adjacent position
-    inline int countEmptyRay(const Board& b, int x, int y, int dx, int dy, int cap = 4) noexcept
-    {
-        int n = 0;
-        int nx = x, ny = y; // ← on commence à la case adjacente
-        while (n < cap && isEmpty(b, nx, ny)) {
-            ++n;
-            nx += dx;
-            ny += dy;
-        }
-        return n;
-    }
-
-    // Helper: Detect capture threat pattern _OOX or XOO_ (opponent stones can be captured)
-    inline bool hasCapturePattern(const Board& b, int x, int y, int dx, int dy, Cell me, Cell opp) noexcept
-    {
-        // Pattern: X O O _ - can capture if we play at the empty spot
-        if (inside(x + 3 * dx, y + 3 * dy)) {
-            Cell c1 = b.at(static_cast<uint8_t>(x), static_cast<uint8_t>(y));
-            Cell c2 = b.at(static_cast<uint8_t>(x + dx), static_cast<uint8_t>(y + dy));
-            Cell c3 = b.at(static_cast<uint8_t>(x + 2 * dx), static_cast<uint8_t>(y + 2 * dy));
-            if (c1 == me && c2 == opp && c3 == opp && isEmpty(b, x + 3 * dx, y + 3 * dy))
-                return true;
-        }
-        // Pattern: _ O O X - can capture if we play at the empty spot
-        if (inside(x - 3 * dx, y - 3 * dy)) {
-            Cell c1 = b.at(static_cast<uint8_t>(x), static_cast<uint8_t>(y));
-            Cell c2 = b.at(static_cast<uint8_t>(x - dx), static_cast<uint8_t>(y - dy));
-            Cell c3 = b.at(static_cast<uint8_t>(x - 2 * dx), static_cast<uint8_t>(y - 2 * dy));
-            if (c1 == me && c2 == opp && c3 == opp && isEmpty(b, x - 3 * dx, y - 3 * dy))
-                return true;
-        }
-        return false;
-    }
-
     // Helper: Detect if an alignment can potentially extend to 5
     inline bool canExtendToFive(int len, int spaceBefore, int spaceAfter)
     {
@@ -78,8 +32,26 @@ namespace {
     }
 }
 
+Evaluator::Evaluator(const EvalConfig& cfg)
+{
+    setConfig(cfg);
+}
+
+void Evaluator::setConfig(const EvalConfig& cfg)
+{
+    cfg_ = cfg;
+    nnue_.reset();
+    if (!cfg_.useNnue)
+        return;
+    nnue_ = NnueNetwork::open(cfg_.nnueFile);
+    if (!nnue_)
+        LOG_WARNING("NNUE network '" + cfg_.nnueFile + "' unusable, pattern evaluation used");
+}
+
 int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
 {
+    if (nnue_)
+        return nnue_->evaluate(board, perspective);
     // Safety: terminal states are handled by isTerminal() in search, but keep neutral for draws here.
     if (board.status() == GameStatus::Draw)
         return 0;
@@ -98,9 +70,10 @@ int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
     constexpr int cx = BOARD_SIZE / 2;
     constexpr int cy = BOARD_SIZE / 2;
     int central = 0;
+    const BoardState& st = board.rawState();
     const auto& occ = board.occupiedPositions();
     for (const auto& p : occ) {
-        const Cell c = board.at(p.x, p.y);
+        const Cell c = st.getCell(p);
         const int md = std::abs(static_cast<int>(p.x) - cx) + std::abs(static_cast<int>(p.y) - cy);
         const int w = std::max(0, cfg_.centerBase - md);
         if (c == me)
@@ -114,11 +87,12 @@ int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
     {
         // Weights for last moves: most recent gets highest weight
         constexpr int W1 = 3, W2 = 2, W3 = 1; // sum = 6
-        const auto recents = board.lastMoves(3);
-        if (!recents.empty()) {
+        std::array<Move, 3> recents;
+        const std::size_t nRecent = board.lastMoves(recents.size(), recents.data());
+        if (nRecent > 0) {
             int frontAccum = 0;
             int weightSum = 0;
-            for (std::size_t i = 0; i < recents.size(); ++i) {
+            for (std::size_t i = 0; i < nRecent; ++i) {
                 const int wMove = (i == 0 ? W1 : (i == 1 ? W2 : W3));
                 weightSum += wMove;
                 const int lx = recents[i].pos.x;
@@ -128,7 +102,7 @@ int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
                     const int md = std::abs(static_cast<int>(p.x) - lx) + std::abs(static_cast<int>(p.y) - ly);
                     if (md > cfg_.frontBase)
                         continue;
-                    const Cell c = board.at(p.x, p.y);
+                    const Cell c = st.getCell(p);
                     const int w = cfg_.frontBase - md;
                     if (c == me)
                         frontLocal += w;
@@ -182,7 +156,6 @@ int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
         return adjustedValue;
     };
 
-    constexpr int DIRS[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 1, -1 } };
     int patternScore = 0;
     int potentialCaptureScore = 0;
 
@@ -193,51 +166,39 @@ int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
     int myThreats[5] = { 0 }; // Index: [open_fours, closed_fours, open_threes, closed_threes, twos]
     int oppThreats[5] = { 0 };
 
-    // UNIFIED LOOP: Count patterns, score runs, detect threats and capture patterns in one pass
+    // UNIFIED LOOP: Count patterns, score runs, detect threats and capture patterns in one pass.
+    // Each (stone, direction) reads its line as three words (own, other, empty) and works on bits.
     for (const auto& p : occ) {
-        const Cell c = board.at(p.x, p.y);
-        const int x = static_cast<int>(p.x);
-        const int y = static_cast<int>(p.y);
+        const Cell c = st.getCell(p);
+        const Cell o = (c == Cell::Black) ? Cell::White : Cell::Black;
+        const uint16_t pi = BoardState::idx(p);
 
-        for (const auto& d : DIRS) {
-            const int dx = d[0], dy = d[1];
-            const int prevX = x - dx, prevY = y - dy;
+        for (int d = 0; d < lines::DIRS; ++d) {
+            const lines::Coord lc = lines::coords[d][pi];
+            const int b = lc.bit;
+            const uint32_t M = st.lineBits(c, d, lc.line);
+            const uint32_t O = st.lineBits(o, d, lc.line);
+            const uint32_t E = st.lineEmpty(d, lc.line);
 
             // Only start at the beginning of a run for this direction
-            if (inside(prevX, prevY)) {
-                if (board.at(static_cast<uint8_t>(prevX), static_cast<uint8_t>(prevY)) == c)
-                    continue;
-                // Avoid double counting split patterns (if we are the second part of X _ X)
-                if (isEmpty(board, prevX, prevY) && inside(prevX - dx, prevY - dy) && board.at(static_cast<uint8_t>(prevX - dx), static_cast<uint8_t>(prevY - dy)) == c)
-                    continue;
-            }
+            if (lines::test(M, b - 1))
+                continue;
+            // Avoid double counting split patterns (if we are the second part of X _ X)
+            if (lines::test(E, b - 1) && lines::test(M, b - 2))
+                continue;
 
             // Count run length
-            int len = 0;
-            int nx = x, ny = y;
-            while (inside(nx, ny) && board.at(static_cast<uint8_t>(nx), static_cast<uint8_t>(ny)) == c) {
-                ++len;
-                nx += dx;
-                ny += dy;
-            }
+            const int len = lines::runUp(M, b);
+            const int n = b + len; // first cell after the run
 
-            const bool leftOpen = isEmpty(board, prevX, prevY);
-            const bool rightOpen = isEmpty(board, nx, ny);
+            const bool leftOpen = lines::test(E, b - 1);
+            const bool rightOpen = lines::test(E, n);
 
             // Check for split pattern (broken four/five)
-            int len2 = 0;
-            int nx2 = nx + dx;
-            int ny2 = ny + dy;
-            if (rightOpen) {
-                while (inside(nx2, ny2) && board.at(static_cast<uint8_t>(nx2), static_cast<uint8_t>(ny2)) == c) {
-                    ++len2;
-                    nx2 += dx;
-                    ny2 += dy;
-                }
-            }
+            const int len2 = rightOpen ? lines::runUp(M, n + 1) : 0;
 
-            const int leftSpace = leftOpen ? countEmptyRay(board, prevX, prevY, -dx, -dy) : 0;
-            const int rightSpace = rightOpen ? countEmptyRay(board, nx, ny, dx, dy) : 0;
+            const int leftSpace = leftOpen ? std::min(4, lines::runDown(E, b - 1)) : 0;
+            const int rightSpace = rightOpen ? std::min(4, lines::runUp(E, n)) : 0;
 
             const int openEnds = (leftOpen ? 1 : 0) + (rightOpen ? 1 : 0);
 
@@ -265,7 +226,7 @@ int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
                     threats[1]++; // closed_four
                 } else if (splitTotal == 3) {
                     // Check if the far end is open
-                    bool rightOpen2 = inside(nx2, ny2) && isEmpty(board, nx2, ny2);
+                    bool rightOpen2 = lines::test(E, n + 1 + len2);
                     int splitEnds = (leftOpen ? 1 : 0) + (rightOpen2 ? 1 : 0);
 
                     if (splitEnds >= 2) {
@@ -288,10 +249,12 @@ int Evaluator::evaluate(const Board& board, Player perspective) const noexcept
                     patternScore -= splitVal;
             }
 
-            // Check for capture patterns (X_OOX)
-            if (c == me && hasCapturePattern(board, x, y, dx, dy, me, opp)) {
+            // Check for capture patterns (X_OOX): X O O _ in either direction
+            const bool capturePattern = (lines::test(O, b + 1) && lines::test(O, b + 2) && lines::test(E, b + 3))
+                || (lines::test(O, b - 1) && lines::test(O, b - 2) && lines::test(E, b - 3));
+            if (capturePattern && c == me) {
                 potentialCaptureScore += cfg_.captureSetupBonus; // Bonus for potential capture setup
-            } else if (c == opp && hasCapturePattern(board, x, y, dx, dy, opp, me)) {
+            } else if (capturePattern && c == opp) {
                 int penalty = cfg_.captureSetupPenalty;
                 if (oppCaptures >= 4)
                     penalty *= 6;
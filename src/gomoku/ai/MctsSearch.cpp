@@ -0,0 +1,427 @@
+// MctsSearch.cpp - PUCT Monte Carlo tree search, tree parallelism with virtual loss
+#include "gomoku/ai/MctsSearch.hpp"
+#include "gomoku/ai/SearchHelpers.hpp"
+#include "gomoku/core/Board.hpp"
+#include "util/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <thread>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+namespace {
+    constexpr int CHECKS_PER_OPTIMUM = 8; // contrôles du temps souple par optimumMs
+
+    inline bool isWin(GameStatus s) noexcept
+    {
+        return s == GameStatus::WinByAlign || s == GameStatus::WinByCapture;
+    }
+} // namespace
+
+struct MctsSearch::Ponder {
+    Board board;
+    RuleSet rules;
+    SearchDeadline deadline { SearchDeadline::clock::time_point::max() };
+    TimeManager time { TimeManager::Limits {}, deadline }; // limites fixées au ponder hit
+    SearchStats stats {};
+    std::optional<Move> result {};
+    std::thread thread {};
+};
+
+MctsSearch::MctsSearch(const MctsConfig& conf, const eval::EvalConfig& evalConf)
+    : cfg_(conf)
+    , evaluator_(evalConf)
+{
+}
+
+MctsSearch::~MctsSearch()
+{
+    stopPonder();
+}
+
+void MctsSearch::setArenaBytes(std::size_t bytes)
+{
+    stopPonder();
+    cfg_.arenaBytes = bytes;
+    clear();
+}
+
+void MctsSearch::clear()
+{
+    stopPonder();
+    nodes_.reset();
+    capacity_ = 0;
+    used_.store(0, std::memory_order_relaxed);
+}
+
+void MctsSearch::allocateArena()
+{
+    if (nodes_)
+        return;
+    capacity_ = std::max<std::size_t>(2, std::min<std::size_t>(cfg_.arenaBytes / sizeof(Node), std::numeric_limits<uint32_t>::max() / 2));
+    nodes_ = std::make_unique<Node[]>(capacity_);
+}
+
+std::size_t MctsSearch::treeSize() const noexcept
+{
+    return std::min<std::size_t>(used_.load(std::memory_order_relaxed), capacity_);
+}
+
+void MctsSearch::startPonder(const Board& board, const RuleSet& rules)
+{
+    stopPonder();
+    ponder_.reset(new Ponder { board, rules });
+    Ponder& p = *ponder_;
+    p.thread = std::thread([this, &p] { p.result = search(p.board, p.rules, &p.stats, p.deadline, p.time); });
+}
+
+std::optional<Move> MctsSearch::ponderHit(int timeMs, SearchStats* stats)
+{
+    SearchStats localStats;
+    if (!stats)
+        stats = &localStats;
+    if (!ponder_) {
+        stats->clear();
+        return std::nullopt;
+    }
+    // The soft window is the hit's: same limits as the moved deadline
+    if (cfg_.playoutBudget == 0) {
+        const auto limits = TimeManager::allocate(timeMs, cfg_.clock, cfg_.softTimePercent);
+        ponder_->time.setLimits(limits);
+        ponder_->deadline.set(std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.hardMs));
+    }
+    ponder_->thread.join();
+    stopRequested_.store(false, std::memory_order_relaxed); // stop() reçu pendant la réflexion : consommé
+    const auto result = ponder_->result;
+    *stats = ponder_->stats;
+    ponder_.reset();
+    return result;
+}
+
+void MctsSearch::stopPonder()
+{
+    if (!ponder_)
+        return;
+    stopRequested_.store(true, std::memory_order_relaxed);
+    ponder_->thread.join();
+    stopRequested_.store(false, std::memory_order_relaxed);
+    ponder_.reset();
+}
+
+std::optional<Move> MctsSearch::bestMove(Board& board, const RuleSet& rules, SearchStats* stats)
+{
+    stopPonder();
+    allocateArena(); // hors du temps de réflexion
+    const auto limits = TimeManager::allocate(cfg_.timeBudgetMs, cfg_.clock, cfg_.softTimePercent);
+    const SearchDeadline deadline { cfg_.playoutBudget > 0 ? SearchDeadline::clock::time_point::max()
+                                                           : std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.hardMs) };
+    TimeManager time(limits, deadline);
+    // A stop() raised before this point aborts this search; the flag is consumed at its end
+    auto result = search(board, rules, stats, deadline, time);
+    stopRequested_.store(false, std::memory_order_relaxed);
+    return result;
+}
+
+std::optional<Move> MctsSearch::search(Board& board, const RuleSet& rules, SearchStats* stats, const SearchDeadline& deadline, TimeManager& time)
+{
+    using namespace std::chrono;
+    const auto start = steady_clock::now();
+    SearchStats localStats;
+    if (!stats)
+        stats = &localStats;
+    stats->clear();
+    if (board.status() != GameStatus::Ongoing) {
+        SearchStats::setEmpty(stats, start);
+        return std::nullopt;
+    }
+
+    allocateArena();
+    used_.store(1, std::memory_order_relaxed);
+    arenaFull_.store(false, std::memory_order_relaxed);
+    playouts_.store(0, std::memory_order_relaxed);
+    searchDone_.store(false, std::memory_order_relaxed);
+    deadline_ = &deadline;
+
+    Node& root = nodes_[0];
+    root.visits.store(1, std::memory_order_relaxed);
+    root.childCount = 0;
+    root.firstChild = 0;
+    root.move = Move { Pos {}, opponent(board.toPlay()) };
+    root.state.store(Expanding, std::memory_order_relaxed);
+    root.valueSum.store(-std::llround(static_cast<double>(expand(board, rules, root)) * VALUE_ONE), std::memory_order_relaxed);
+
+    // Nothing to search: no legal move, a single one, or a move that wins at once
+    if (root.state.load(std::memory_order_relaxed) != Expanded) {
+        SearchStats::setEmpty(stats, start);
+        return std::nullopt;
+    }
+    if (root.childCount == 1) {
+        const Move only = nodes_[root.firstChild].move;
+        stats->finalize(start, 1, { only });
+        return only;
+    }
+
+    // Tree parallelism: the helpers run playouts on their own board copies until stopped
+    const int threads = std::max(1, cfg_.threads);
+    std::vector<Board> helperBoards(static_cast<std::size_t>(threads - 1), board);
+    std::vector<SearchStats> helperStats(helperBoards.size());
+    std::vector<std::thread> workers;
+    for (std::size_t k = 0; k < helperBoards.size(); ++k) {
+        workers.emplace_back([&, k] {
+            std::vector<uint32_t> path;
+            while (playout(helperBoards[k], rules, path, helperStats[k])) { }
+        });
+    }
+
+    // Soft limit: every optimumMs / 8 the root counts as an iteration of the TimeManager. The
+    // period is read at each check: a ponder hit sets the limits while the search runs, and
+    // no check happens before that (optimumMs 0: pondering has no soft limit).
+    const bool adaptive = cfg_.adaptiveTime && cfg_.playoutBudget == 0;
+    auto checkPeriod = [&time] { return milliseconds(std::max(1, time.limits().optimumMs / CHECKS_PER_OPTIMUM)); };
+    auto nextCheck = start + checkPeriod();
+    std::vector<uint32_t> path;
+    while (playout(board, rules, path, *stats)) {
+        if (!adaptive)
+            continue;
+        const auto now = steady_clock::now();
+        if (now < nextCheck || time.limits().optimumMs == 0)
+            continue;
+        nextCheck = now + checkPeriod();
+        const Node* best = bestChild(root);
+        const bool won = best->state.load(std::memory_order_acquire) == Terminal && best->terminal > 0.f;
+        const double share = static_cast<double>(best->visits.load(std::memory_order_relaxed)) / std::max(1, root.visits.load(std::memory_order_relaxed));
+        const double q = std::clamp(meanValue(*best), -0.999, 0.999);
+        const int score = won ? search::MATE_SCORE : static_cast<int>(cfg_.valueScale * std::atanh(q));
+        if (time.iterationDone(best->move, score, share, now))
+            break;
+    }
+
+    searchDone_.store(true, std::memory_order_relaxed);
+    for (auto& w : workers)
+        w.join();
+    for (const auto& hs : helperStats)
+        stats->mergeCounters(hs);
+
+    const Node* best = bestChild(root);
+    const auto pv = principalVariation();
+    stats->finalize(start, static_cast<int>(pv.size()), pv);
+    LOG_INFO("MCTS finished. Playouts: " + std::to_string(stats->nodes) + ", tree nodes: " + std::to_string(treeSize())
+        + ", best visits: " + std::to_string(best->visits.load(std::memory_order_relaxed)));
+    return best->move;
+}
+
+bool MctsSearch::playout(Board& board, const RuleSet& rules, std::vector<uint32_t>& path, SearchStats& stats)
+{
+    if (stopRequested_.load(std::memory_order_relaxed) || searchDone_.load(std::memory_order_relaxed) || deadline_->passed(std::chrono::steady_clock::now()))
+        return false;
+    if (playouts_.fetch_add(1, std::memory_order_relaxed) >= cfg_.playoutBudget && cfg_.playoutBudget > 0)
+        return false;
+
+    const int32_t vl = cfg_.virtualLoss;
+    path.clear();
+    path.push_back(0);
+    uint32_t idx = 0;
+    float value; // pour le camp qui a joué le coup du dernier nœud du chemin
+    for (;;) {
+        Node& node = nodes_[idx];
+        const uint8_t state = node.state.load(std::memory_order_acquire);
+        if (state == Terminal) {
+            value = node.terminal;
+            break;
+        }
+        if (state == Expanded) {
+            idx = selectChild(node);
+            Node& child = nodes_[idx];
+            child.visits.fetch_add(vl, std::memory_order_relaxed);
+            child.valueSum.fetch_sub(vl * VALUE_ONE, std::memory_order_relaxed);
+            board.makeMove(child.move, rules); // légal : vérifié au développement du parent
+            path.push_back(idx);
+            continue;
+        }
+        // Leaf, or being developed by another thread: evaluated as it stands
+        uint8_t expected = Leaf;
+        const int depth = static_cast<int>(path.size()) - 1;
+        if (state == Leaf && depth < cfg_.maxDepth && !arenaFull_.load(std::memory_order_relaxed)
+            && node.state.compare_exchange_strong(expected, Expanding, std::memory_order_acq_rel))
+            value = -expand(board, rules, node);
+        else
+            value = -leafValue(board);
+        break;
+    }
+
+    // Backup: the virtual losses of the descent become this playout's result
+    for (std::size_t i = path.size(); i-- > 0;) {
+        Node& node = nodes_[path[i]];
+        const int64_t v = std::llround(static_cast<double>(value) * VALUE_ONE);
+        if (i > 0) {
+            node.visits.fetch_add(1 - vl, std::memory_order_relaxed);
+            node.valueSum.fetch_add(v + vl * VALUE_ONE, std::memory_order_relaxed);
+            board.unmakeMove();
+        } else {
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+            node.valueSum.fetch_add(v, std::memory_order_relaxed);
+        }
+        value = -value;
+    }
+    ++stats.nodes;
+    stats.maxDepth = std::max(stats.maxDepth, static_cast<int>(path.size()) - 1);
+    return true;
+}
+
+float MctsSearch::expand(Board& board, const RuleSet& rules, Node& node)
+{
+    const auto scored = scoreMoves(board, rules);
+    if (scored.empty()) {
+        node.terminal = 0.f; // aucun coup légal : nulle
+        node.state.store(Terminal, std::memory_order_release);
+        return 0.f;
+    }
+
+    const auto count = static_cast<uint32_t>(std::min<std::size_t>(scored.size(), static_cast<std::size_t>(std::max(1, cfg_.maxChildren))));
+    const uint32_t first = used_.fetch_add(count, std::memory_order_relaxed);
+    if (static_cast<std::size_t>(first) + count > capacity_) {
+        arenaFull_.store(true, std::memory_order_relaxed);
+        node.state.store(Leaf, std::memory_order_release);
+        return leafValue(board);
+    }
+
+    // Priors: softmax of the scores after each move
+    const double best = scored.front().score;
+    std::vector<double> weights(count);
+    double total = 0.0;
+    for (uint32_t i = 0; i < count; ++i)
+        total += weights[i] = std::exp((scored[i].score - best) / cfg_.priorTemperature);
+    for (uint32_t i = 0; i < count; ++i) {
+        Node& child = nodes_[first + i];
+        child.visits.store(0, std::memory_order_relaxed);
+        child.valueSum.store(0, std::memory_order_relaxed);
+        child.childCount = 0;
+        child.firstChild = 0;
+        child.move = scored[i].move;
+        child.prior = static_cast<float>(weights[i] / total);
+        child.terminal = scored[i].win ? 1.f : 0.f;
+        child.state.store(scored[i].win || scored[i].draw ? Terminal : Leaf, std::memory_order_relaxed);
+    }
+    node.firstChild = first;
+    node.childCount = static_cast<uint16_t>(count);
+    node.state.store(Expanded, std::memory_order_release);
+    return scored.front().win ? 1.f : leafValue(board);
+}
+
+uint32_t MctsSearch::selectChild(const Node& node) const noexcept
+{
+    const int32_t parentVisits = node.visits.load(std::memory_order_relaxed);
+    const double sqrtN = std::sqrt(static_cast<double>(std::max(1, parentVisits)));
+    // First play urgency: an unvisited move is assumed a bit worse than the parent position
+    const double fpu = (parentVisits > 0 ? -meanValue(node) : 0.0) - cfg_.fpuReduction;
+
+    uint32_t best = node.firstChild;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+        const Node& child = nodes_[i];
+        const int32_t n = child.visits.load(std::memory_order_relaxed);
+        double q;
+        if (child.state.load(std::memory_order_relaxed) == Terminal)
+            q = child.terminal;
+        else
+            q = n > 0 ? meanValue(child) : fpu;
+        const double score = q + cfg_.cpuct * child.prior * sqrtN / (1 + std::max(0, n));
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+float MctsSearch::leafValue(const Board& board) const
+{
+    return std::tanh(static_cast<float>(evaluator_.evaluate(board, board.toPlay())) / cfg_.valueScale);
+}
+
+std::vector<MctsSearch::Scored> MctsSearch::scoreMoves(Board& board, const RuleSet& rules) const
+{
+    const Player toPlay = board.toPlay();
+    std::vector<Scored> out;
+    // True on a move that wins at once, then the only one kept
+    auto scan = [&](const std::vector<Move>& moves) {
+        for (const Move& m : moves) {
+            if (!board.makeMove(m, rules))
+                continue;
+            const GameStatus st = board.status();
+            if (isWin(st)) {
+                board.unmakeMove();
+                out.assign(1, Scored { m, evaluator_.getConfig().winValue, true, false });
+                return true;
+            }
+            const bool draw = st == GameStatus::Draw;
+            out.push_back(Scored { m, draw ? 0 : evaluator_.evaluate(board, toPlay), false, draw });
+            board.unmakeMove();
+        }
+        return false;
+    };
+    // Candidates may all be illegal (a five to break by capture): fall back to every legal move
+    if (!scan(CandidateGenerator::generate(board, rules, toPlay, cfg_.expansion)) && out.empty())
+        scan(board.legalMoves(toPlay, rules));
+    std::stable_sort(out.begin(), out.end(), [](const Scored& a, const Scored& b) { return a.score > b.score; });
+    return out;
+}
+
+const MctsSearch::Node* MctsSearch::bestChild(const Node& node) const noexcept
+{
+    if (node.state.load(std::memory_order_acquire) != Expanded)
+        return nullptr;
+    const Node* best = nullptr;
+    for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+        const Node& child = nodes_[i];
+        if (child.state.load(std::memory_order_relaxed) == Terminal && child.terminal > 0.f)
+            return &child;
+        if (!best) {
+            best = &child;
+            continue;
+        }
+        const int32_t n = child.visits.load(std::memory_order_relaxed);
+        const int32_t bn = best->visits.load(std::memory_order_relaxed);
+        if (n > bn || (n == bn && meanValue(child) > meanValue(*best)))
+            best = &child;
+    }
+    return best;
+}
+
+std::vector<Move> MctsSearch::principalVariation() const
+{
+    std::vector<Move> pv;
+    for (const Node* node = bestChild(nodes_[0]); node; node = bestChild(*node)) {
+        pv.push_back(node->move);
+        if (node->visits.load(std::memory_order_relaxed) == 0)
+            break;
+    }
+    return pv;
+}
+
+double MctsSearch::meanValue(const Node& node) noexcept
+{
+    const int32_t n = node.visits.load(std::memory_order_relaxed);
+    if (n <= 0)
+        return 0.0;
+    return static_cast<double>(node.valueSum.load(std::memory_order_relaxed)) / (static_cast<double>(n) * VALUE_ONE);
+}
+
+int MctsSearch::evaluatePublic(const Board& board, Player perspective) const
+{
+    return evaluator_.evaluate(board, perspective);
+}
+
+std::vector<Move> MctsSearch::orderedMovesPublic(const Board& board, const RuleSet& rules) const
+{
+    Board copy = board;
+    const auto scored = scoreMoves(copy, rules);
+    std::vector<Move> out;
+    for (std::size_t i = 0; i < scored.size() && static_cast<int>(i) < cfg_.maxChildren; ++i)
+        out.push_back(scored[i].move);
+    return out;
+}
+
+} // namespace gomoku
@@ -0,0 +1,118 @@
+#include "gomoku/ai/MctsSearchEngine.hpp"
+#include "gomoku/core/Board.hpp"
+#include "gomoku/interfaces/IBoardView.hpp"
+
+namespace gomoku::inline GOMOKU_SIZE_NS::ai {
+
+MctsSearchEngine::MctsSearchEngine()
+    : searchImpl_(MctsConfig {})
+    , config_ {}
+{
+}
+
+MctsSearchEngine::MctsSearchEngine(const MctsConfig& config)
+    : searchImpl_(config)
+    , config_(config)
+{
+}
+
+void MctsSearchEngine::setTimeLimit(int milliseconds)
+{
+    config_.timeBudgetMs = milliseconds;
+    searchImpl_.setTimeBudgetMs(milliseconds);
+}
+
+void MctsSearchEngine::setDepthLimit(int maxDepth)
+{
+    config_.maxDepth = maxDepth;
+    searchImpl_.setMaxDepth(maxDepth);
+}
+
+void MctsSearchEngine::setTranspositionTableSize(size_t bytes)
+{
+    config_.arenaBytes = bytes;
+    searchImpl_.setArenaBytes(bytes);
+}
+
+void MctsSearchEngine::setThreadCount(int threads)
+{
+    config_.threads = threads < 1 ? 1 : threads;
+    searchImpl_.setThreadCount(threads);
+}
+
+void MctsSearchEngine::setGameClock(const GameClock& clock)
+{
+    config_.clock = clock;
+    searchImpl_.setGameClock(clock);
+}
+
+void MctsSearchEngine::setNodeBudget(unsigned long long nodes)
+{
+    config_.playoutBudget = nodes;
+    searchImpl_.setPlayoutBudget(nodes);
+}
+
+std::optional<Move> MctsSearchEngine::findBestMove(const IBoardView& board, const RuleSet& rules, SearchStats* stats)
+{
+    Board concreteBoard = static_cast<const Board&>(board);
+    auto result = searchImpl_.bestMove(concreteBoard, rules, stats);
+    lastStats_ = stats ? *stats : SearchStats {};
+    return result;
+}
+
+std::optional<Move> MctsSearchEngine::suggestMove(const IBoardView& board, const RuleSet& rules, int timeMs, SearchStats* stats)
+{
+    const int oldTimeMs = config_.timeBudgetMs;
+    setTimeLimit(timeMs);
+    auto res = findBestMove(board, rules, stats);
+    setTimeLimit(oldTimeMs);
+    return res;
+}
+
+void MctsSearchEngine::stop()
+{
+    searchImpl_.stop();
+}
+
+void MctsSearchEngine::startPondering(const IBoardView& board, const RuleSet& rules)
+{
+    searchImpl_.startPonder(static_cast<const Board&>(board), rules);
+}
+
+std::optional<Move> MctsSearchEngine::ponderHit(int timeMs, SearchStats* stats)
+{
+    auto result = searchImpl_.ponderHit(timeMs, stats);
+    lastStats_ = stats ? *stats : SearchStats {};
+    return result;
+}
+
+void MctsSearchEngine::stopPondering()
+{
+    searchImpl_.stopPonder();
+}
+
+int MctsSearchEngine::evaluatePosition(const IBoardView& board, Player perspective) const
+{
+    if (auto concreteBoard = dynamic_cast<const Board*>(&board))
+        return searchImpl_.evaluatePublic(*concreteBoard, perspective);
+    return 0;
+}
+
+std::vector<Move> MctsSearchEngine::getOrderedMoves(const IBoardView& board, const RuleSet& rules) const
+{
+    if (auto concreteBoard = dynamic_cast<const Board*>(&board))
+        return searchImpl_.orderedMovesPublic(*concreteBoard, rules);
+    return {};
+}
+
+void MctsSearchEngine::clearTranspositionTable()
+{
+    searchImpl_.clear();
+}
+
+SearchStats MctsSearchEngine::getLastSearchStats() const
+{
+    return lastStats_;
+}
+
+} // namespace gomoku::ai
@@ -7,11 +7,14 @@
 #include "gomoku/core/Board.hpp"
 #include "util/Logger.hpp"
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <sstream>
+#include <thread>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 namespace {
     // Generate root candidates with fallback to legal moves
@@ -33,15 +36,163 @@ namespace {
         return oss.str();
     }
 
+    // Node limit of a search: the node budget and/or the hard cap, whichever is lower (0 = none)
+    inline unsigned long long nodeLimit(const SearchConfig& c)
+    {
+        if (c.nodeBudget > 0 && c.nodeCap > 0)
+            return std::min(c.nodeBudget, c.nodeCap);
+        return c.nodeBudget > 0 ? c.nodeBudget : c.nodeCap;
+    }
+
+    // Clock polling: nodes between two reads so that the clock is read about every 0.5 ms
+    constexpr long long POLL_PERIOD_US = 500;
+    inline uint32_t pollIntervalFor(long long nodes, long long elapsedUs)
+    {
+        return static_cast<uint32_t>(std::clamp(nodes * POLL_PERIOD_US / elapsedUs, 16LL, 4096LL));
+    }
+
 } // namespace
 
-// Note: cellOf and other are now available as playerToCell and opponent in Types.hpp
+// The ponder search runs on its own MinimaxSearch (orderer, evaluator, solvers), sharing the
+// TT and the owner's stop flag: the owner's public helpers stay usable from the UI thread.
+struct MinimaxSearch::Ponder {
+    Board board;
+    RuleSet rules;
+    std::unique_ptr<MinimaxSearch> search {};
+    SearchDeadline deadline { SearchDeadline::clock::time_point::max() };
+    TimeManager time { TimeManager::Limits {}, deadline }; // limites fixées au ponder hit
+    SearchStats stats {};
+    std::optional<Move> result {};
+    std::thread thread {};
+};
+
+MinimaxSearch::MinimaxSearch(const SearchConfig& conf, const eval::EvalConfig& evalConf)
+    : cfg(conf)
+    , tt(conf.sharedTT ? ttpool::acquire() : std::make_shared<TranspositionTable>())
+    , evaluator_(evalConf)
+    , threats_(conf.threatSearch)
+    , race_(conf.captureRace)
+{
+    if (!cfg.sharedTT) {
+        tt->resizeBytes(cfg.ttBytes); // Initialize TT with configured size
+        if (cfg.prefaultTT)
+            tt->prefault();
+    }
+}
+
+MinimaxSearch::MinimaxSearch(const SearchConfig& conf, const eval::EvalConfig& evalConf, std::shared_ptr<TranspositionTable> sharedTT)
+    : cfg(conf)
+    , tt(std::move(sharedTT))
+    , evaluator_(evalConf)
+    , threats_(conf.threatSearch)
+    , race_(conf.captureRace)
+{
+}
+
+MinimaxSearch::~MinimaxSearch()
+{
+    stopPonder();
+}
+
+bool MinimaxSearch::saveTranspositionTable(const std::string& path, const RuleSet& rules) const
+{
+    return tt->saveFile(path, search::ttFingerprint(rules));
+}
+
+bool MinimaxSearch::saveTranspositionTable() const
+{
+    return ttFileRules_ && saveTranspositionTable(cfg.ttFile, *ttFileRules_);
+}
+
+bool MinimaxSearch::loadTranspositionTable(const std::string& path, const RuleSet& rules)
+{
+    stopPonder();
+    if (cfg.sharedTT)
+        return false;
+    return tt->loadFile(path, search::ttFingerprint(rules));
+}
+
+void MinimaxSearch::loadTranspositionFile(const RuleSet& rules)
+{
+    if (cfg.ttFile.empty() || cfg.sharedTT || ttFileRules_)
+        return;
+    loadTranspositionTable(cfg.ttFile, rules); // missing or stale file: start cold
+    ttFileRules_ = rules;
+}
+
+void MinimaxSearch::startPonder(const Board& board, const RuleSet& rules)
+{
+    stopPonder();
+    loadTranspositionFile(rules); // le fichier va dans la table partagée avec la réflexion
+    SearchConfig ponderCfg = cfg;
+    ponderCfg.ttFile.clear();
+    ponder_.reset(new Ponder { board, rules });
+    Ponder& p = *ponder_;
+    p.search.reset(new MinimaxSearch(ponderCfg, evaluator_.getConfig(), tt));
+    p.search->stop_ = &stopRequested_;
+    p.search->pollInterval_ = pollInterval_;
+    p.thread = std::thread([&p] { p.result = p.search->search(p.board, p.rules, &p.stats, p.deadline, p.time); });
+}
+
+std::optional<Move> MinimaxSearch::ponderHit(int timeMs, SearchStats* stats)
+{
+    SearchStats localStats;
+    if (!stats)
+        stats = &localStats;
+    if (!ponder_) {
+        stats->clear();
+        return std::nullopt;
+    }
+    // The search may already be done (maxDepthHint reached): join returns at once.
+    // Node budget mode: the pondering search simply runs to the end of its budget.
+    // The soft window is the hit's: same limits as the moved deadline.
+    if (cfg.nodeBudget == 0) {
+        const auto limits = TimeManager::allocate(timeMs, cfg.clock, cfg.softTimePercent);
+        ponder_->time.setLimits(limits);
+        ponder_->deadline.set(std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.hardMs));
+    }
+    ponder_->thread.join();
+    stopRequested_.store(false, std::memory_order_relaxed); // stop() reçu pendant la réflexion : consommé
+    pollInterval_ = ponder_->search->pollInterval_;
+    const auto result = ponder_->result;
+    *stats = ponder_->stats;
+    ponder_.reset();
+    return result;
+}
+
+void MinimaxSearch::stopPonder()
+{
+    if (!ponder_)
+        return;
+    stopRequested_.store(true, std::memory_order_relaxed);
+    ponder_->thread.join();
+    stopRequested_.store(false, std::memory_order_relaxed);
+    ponder_.reset();
+}
+
 std::optional<Move> MinimaxSearch::bestMove(Board& board, const RuleSet& rules, SearchStats* stats)
+{
+    stopPonder();
+    const auto limits = TimeManager::allocate(cfg.timeBudgetMs, cfg.clock, cfg.softTimePercent);
+    const SearchDeadline deadline { cfg.nodeBudget > 0 ? SearchDeadline::clock::time_point::max()
+                                                       : std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.hardMs) };
+    TimeManager time(limits, deadline);
+    // A stop() raised before this point aborts this search; the flag is consumed at its end
+    auto result = search(board, rules, stats, deadline, time);
+    stopRequested_.store(false, std::memory_order_relaxed);
+    return result;
+}
+
+// Note: cellOf and other are now available as playerToCell and opponent in Types.hpp
+std::optional<Move> MinimaxSearch::search(Board& board, const RuleSet& rules, SearchStats* stats, const SearchDeadline& deadline, TimeManager& time)
 {
     using namespace std::chrono;
     auto start = steady_clock::now();
-    auto deadline = start + milliseconds(cfg.timeBudgetMs);
-    SearchContext ctx { rules, deadline, stats, cfg.nodeCap };
+    SearchStats localStats; // root node shares need the counters even when the caller wants none
+    if (!stats)
+        stats = &localStats;
+    const int threads = std::max(1, cfg.threads);
+    const unsigned long long limit = nodeLimit(cfg);
 
     Player toPlay = board.toPlay();
 
@@ -51,9 +202,7 @@ std::optional<Move> MinimaxSearch::bestMove(Board& board, const RuleSet& rules,
         return std::nullopt;
     };
 
-    // Initialize stats if provided
-    if (stats)
-        stats->clear();
+    stats->clear();
 
     // Early terminal check
     int terminalScore = 0;
@@ -67,24 +216,112 @@ std::optional<Move> MinimaxSearch::bestMove(Board& board, const RuleSet& rules,
 
     // 1) Immediate win shortcut (only if situation permits)
     if (auto iw = search::tryImmediateWin(board, rules, toPlay, candidates)) {
-        if (stats) {
-            // Note: not counting nodes here as this is a shortcut, not a full search
-            stats->finalize(start, /*depth*/ 1, { *iw });
-        }
+        // Note: not counting nodes here as this is a shortcut, not a full search
+        stats->finalize(start, /*depth*/ 1, { *iw });
         return iw;
     }
 
-    // 2) Iterative deepening skeleton with aspiration windows
+    // 2) Threat-space search: forced wins made only of threats, often 15+ plies deep, that
+    // LMR and the orderer caps would prune from the main search. Bounded by its node limit,
+    // and under a node limit by half of it: its nodes are charged to the budget.
+    // Only a VCF is played as is: its defences (block, capture, win) are exhaustive. A VCT
+    // relies on the solver's list of parades to threes; its first move is searched first by
+    // the main search, which keeps it unless it finds a better one.
+    rootHint_.reset();
+    if (cfg.useThreatSearch) {
+        for (const auto mode : { ThreatSearch::Mode::VCF, ThreatSearch::Mode::VCT }) {
+            const long long threatCap = static_cast<long long>(limit / 2) - stats->threatNodes;
+            if (limit > 0 && threatCap <= 0)
+                break;
+            const ThreatResult tr = threats_.solve(board, rules, mode, &deadline, stop_, limit > 0 ? threatCap : 0);
+            stats->threatNodes += tr.nodes;
+            if (!tr.win)
+                continue;
+            LOG_INFO(std::string(mode == ThreatSearch::Mode::VCF ? "VCF" : "VCT") + " win found: "
+                + moveToString(tr.line.front()) + " (" + std::to_string(tr.line.size()) + " plies, "
+                + std::to_string(tr.nodes) + " nodes)");
+            if (mode == ThreatSearch::Mode::VCT) {
+                rootHint_ = tr.line.front();
+                break;
+            }
+            stats->finalize(start, static_cast<int>(tr.line.size()), tr.line);
+            return tr.line.front();
+        }
+    }
+
+    // Node limit left by the solver, split between the threads: the whole search never exceeds it
+    const unsigned long long searchLimit = limit > 0 ? std::max(1ull, limit - static_cast<unsigned long long>(stats->threatNodes)) : 0;
+    const unsigned long long helperCap = limit > 0 ? std::max(1ull, searchLimit / static_cast<unsigned>(threads)) : 0;
+    const unsigned long long mainCap = limit > 0 ? std::max(1ull, searchLimit - helperCap * static_cast<unsigned>(threads - 1)) : 0;
+    SearchContext ctx { rules, deadline, stats, mainCap, stop_, pollInterval_ };
+
+    // 3) Lazy SMP: helpers search the same root on their own board copies, sharing the TT.
+    // Odd helpers start one ply deeper so the threads desynchronise and feed each other's TT.
+    // They stop with the main thread (own flag: *stop_ belongs to the caller).
+    loadTranspositionFile(rules);
+    tt->newSearch(); // entries of previous searches age out first
+
+    std::vector<std::unique_ptr<MinimaxSearch>> helpers;
+    std::vector<Board> helperBoards;
+    std::vector<SearchStats> helperStats(static_cast<std::size_t>(threads - 1));
+    std::vector<std::thread> workers;
+    std::atomic<bool> helpersStop { false };
+    helpers.reserve(helperStats.size());
+    helperBoards.reserve(helperStats.size());
+    for (int k = 1; k < threads; ++k) {
+        helpers.emplace_back(new MinimaxSearch(cfg, evaluator_.getConfig(), tt));
+        helpers.back()->rootHint_ = rootHint_;
+        helperBoards.push_back(board);
+    }
+    for (std::size_t k = 0; k < helpers.size(); ++k) {
+        workers.emplace_back([&, k] {
+            const SearchContext hctx { rules, deadline, &helperStats[k], helperCap, &helpersStop, pollInterval_ };
+            std::optional<Move> helperBest;
+            std::vector<Move> helperPV;
+            helpers[k]->deepen(helperBoards[k], rules, toPlay, candidates, 1 + static_cast<int>((k + 1) & 1u), helperBest, helperPV, hctx, start);
+        });
+    }
+
     std::optional<Move> best;
     std::vector<Move> pv;
+    // Node budget mode: no soft stop either, the result must not depend on the clock
+    const bool adaptive = cfg.adaptiveTime && cfg.nodeBudget == 0;
+    const int reachedDepth = deepen(board, rules, toPlay, candidates, 1, best, pv, ctx, start, adaptive ? &time : nullptr);
+
+    helpersStop.store(true, std::memory_order_relaxed);
+    for (auto& w : workers)
+        w.join();
+    // Recalibrate from this thread's NPS (helpers have their own counters)
+    const long long elapsedUs = duration_cast<microseconds>(steady_clock::now() - start).count();
+    if (elapsedUs >= 4 * POLL_PERIOD_US)
+        pollInterval_ = pollIntervalFor(stats->nodes + stats->qnodes, elapsedUs);
+    for (const auto& hs : helperStats)
+        stats->mergeCounters(hs);
+    if (limit > 0)
+        stats->nodeBudgetOverrun = std::max(0LL, stats->nodes + stats->qnodes + stats->threatNodes + stats->raceNodes - static_cast<long long>(limit));
+    // A timed-out iteration may have changed the move: report the line that goes with it
+    if (!pv.empty())
+        stats->principalVariation = pv;
+
+    if (best) {
+        LOG_INFO("Search finished. Depth reached: " + std::to_string(reachedDepth) + " (Max: " + std::to_string(stats->maxDepth) + ")");
+        return best;
+    }
+
+    return returnEmpty();
+}
+
+int MinimaxSearch::deepen(Board& board, const RuleSet& rules, Player toPlay, const std::vector<Move>& rootCandidates, int startDepth,
+    std::optional<Move>& best, std::vector<Move>& pv, const SearchContext& ctx, std::chrono::steady_clock::time_point start, TimeManager* time)
+{
     int maxDepth = cfg.maxDepthHint;
     int bestScore = -search::INF;
     int reachedDepth = 0;
 
-    for (int depth = 1; depth <= maxDepth; ++depth) {
+    for (int depth = startDepth; depth <= maxDepth; ++depth) {
         reachedDepth = depth;
         int alpha, beta;
-        if (depth == 1)
+        if (depth == startDepth)
             orderer_.clearForNewIteration(/*maxPly=*/64);
         // First few iterations or aspiration disabled: use full window
         // Aspiration windows are more effective at deeper depths when the tree is more stable
@@ -104,9 +341,9 @@ std::optional<Move> MinimaxSearch::bestMove(Board& board, const RuleSet& rules,
         // Aspiration window re-search loop
         while (!searchComplete && windowWidenCount < maxReSearches) {
 
-            if (!runDepthWithWindow(depth, board, rules, toPlay, candidates, best, bestScore, pv, ctx, alpha, beta)) {
+            if (!runDepthWithWindow(depth, board, rules, toPlay, rootCandidates, best, bestScore, pv, ctx, alpha, beta)) {
                 // Search failed (timeout or no moves)
-                goto depth_loop_end;
+                return reachedDepth;
             }
 
             // Check if score fell outside aspiration window
@@ -130,39 +367,19 @@ std::optional<Move> MinimaxSearch::bestMove(Board& board, const RuleSet& rules,
 
         // If we exhausted re-searches, do final full-window search
         if (!searchComplete) {
-            if (!runDepthWithWindow(depth, board, rules, toPlay, candidates, best, bestScore, pv, ctx, -search::INF, search::INF)) {
+            if (!runDepthWithWindow(depth, board, rules, toPlay, rootCandidates, best, bestScore, pv, ctx, -search::INF, search::INF)) {
                 break;
             }
         }
 
         // Finalize metadata for this iteration (counters already updated via ctx.recordNode())
-        if (stats) {
-            stats->finalize(start, depth, pv);
+        if (ctx.stats) {
+            ctx.stats->finalize(start, depth, pv);
         }
+        if (time && best && time->iterationDone(*best, bestScore, rootBestNodeShare_, std::chrono::steady_clock::now()))
+            break;
     }
-depth_loop_end:
-
-    if (best) {
-        // Final summary log with all statistics
-        if (stats) {
-            // Log PV (first few moves)
-            if (!pv.empty()) {
-                std::string pvStr;
-                int pvDisplay = std::min(static_cast<int>(pv.size()), 5);
-                for (int i = 0; i < pvDisplay; ++i) {
-                    pvStr += moveToString(pv[i]);
-                    if (i < pvDisplay - 1)
-                        pvStr += " ";
-                }
-                if (pv.size() > 5)
-                    pvStr += " ...";
-            }
-        }
-        LOG_INFO("Search finished. Depth reached: " + std::to_string(reachedDepth) + " (Max: " + std::to_string(stats ? stats->maxDepth : 0) + ")");
-        return best;
-    }
-
-    return returnEmpty();
+    return reachedDepth;
 }
 
 int MinimaxSearch::evaluatePublic(const Board& board, Player perspective) const
@@ -193,13 +410,9 @@ int MinimaxSearch::negamax(Board& board, int depth, int alpha, int beta, int ply
     // Count this node
     ctx.recordNode();
 
-    // 1) Check time budget
+    // 1-2) Time budget, node cap or stop(): unwind, the caller discards this value
     if (ctx.isTimeUp())
-        return evaluator_.evaluate(board, board.toPlay());
-
-    // 2) Check node cap (hard limit)
-    if (ctx.nodeCap > 0 && ctx.stats && ctx.stats->nodes >= static_cast<long long>(ctx.nodeCap))
-        return evaluator_.evaluate(board, board.toPlay());
+        return 0;
 
     // 3) Terminal check (win/loss/draw)
     int terminalScore = 0;
@@ -215,7 +428,7 @@ int MinimaxSearch::negamax(Board& board, int depth, int alpha, int beta, int ply
     std::optional<Move> ttMove;
     int ttScore = 0;
     TranspositionTable::Flag ttFlag = TranspositionTable::Flag::Exact;
-    if (search::ttProbe(tt, board, depth, alpha, beta, ttScore, ttMove, ttFlag)) {
+    if (search::ttProbe(*tt, board, ctx.rules, depth, alpha, beta, ttScore, ttMove, ttFlag)) {
         // Hit exploitable (Exact ou borne coupante) garanti par ttProbe
         ctx.recordTTHit();
         pvOut.clear();
@@ -224,6 +437,24 @@ int MinimaxSearch::negamax(Board& board, int depth, int alpha, int beta, int ply
         return ttScore;
     }
 
+    // 5b) Capture race: near captureWinPairs an exact verdict replaces the subtree. Its nodes
+    // count against this thread's node cap.
+    if (cfg.useCaptureRace && depth >= cfg.captureRaceMinDepth && (ctx.nodeCap == 0 || ctx.nodesLeft() > 0)
+        && race_.applies(board, ctx.rules)) {
+        const long long before = race_.nodes();
+        const CaptureRace::Result race = race_.decide(board, ctx.rules, ctx.stop, static_cast<long long>(ctx.nodesLeft()));
+        ctx.chargeNodes(static_cast<unsigned long long>(race_.nodes() - before));
+        if (ctx.stats)
+            ctx.stats->raceNodes += race_.nodes() - before;
+        if (race.verdict != CaptureRace::Verdict::Unknown) {
+            if (ctx.stats)
+                ++ctx.stats->raceProofs;
+            // Coup gagnant joué au demi-coup ply + plies - 1 (même convention que isTerminal)
+            const int mate = search::MATE_SCORE - (ply + race.plies);
+            return race.verdict == CaptureRace::Verdict::Win ? mate : -mate;
+        }
+    }
+
     // 6) Generate and order moves
     Player toMove = board.toPlay();
     auto moves = orderer_.order(board, ctx.rules, toMove, depth, ttMove, evaluator_);
@@ -239,9 +470,9 @@ int MinimaxSearch::negamax(Board& board, int depth, int alpha, int beta, int ply
 
     for (size_t i = 0; i < moves.size(); ++i) {
         const auto& m = moves[i];
-        auto pr = board.tryPlay(m, ctx.rules);
-        if (!pr.success)
+        if (!board.makeMove(m, ctx.rules))
             continue;
+        tt->prefetch(search::ttKey(board, ctx.rules)); // le bucket de l'enfant arrive pendant ses premiers tests
 
         foundLegalMove = true;
         std::vector<Move> childPV;
@@ -287,18 +518,11 @@ int MinimaxSearch::negamax(Board& board, int depth, int alpha, int beta, int ply
             }
         }
 
-        board.undo();
+        board.unmakeMove();
 
-        // Si timeout après le premier coup, retourner le meilleur score trouvé
-        if (ctx.isTimeUp()) {
-            if (score > bestScore) {
-                bestScore = score;
-                bestPV.clear();
-                bestPV.push_back(m);
-                bestPV.insert(bestPV.end(), childPV.begin(), childPV.end());
-            }
-            break; // Sortir immédiatement
-        }
+        // Subtree aborted: its score is meaningless, and so is this node's
+        if (ctx.stopped())
+            return 0;
 
         if (score > bestScore) {
             bestScore = score;
@@ -334,9 +558,7 @@ int MinimaxSearch::negamax(Board& board, int depth, int alpha, int beta, int ply
     if (!bestPV.empty())
         bestMove = bestPV.front();
 
-    if (!ctx.isTimeUp()) {
-        search::ttStore(tt, board, depth, bestScore, storeFlag, bestMove);
-    }
+    search::ttStore(*tt, board, ctx.rules, depth, bestScore, storeFlag, bestMove);
 
     pvOut = bestPV;
     return bestScore;
@@ -357,6 +579,10 @@ int MinimaxSearch::qsearch(Board& board, int alpha, int beta, int ply, const Sea
 
     ctx.recordQNode();
 
+    // Aborted: no stand-pat evaluation, the caller discards this value
+    if (ctx.isTimeUp())
+        return 0;
+
     // Check for terminal positions first
     int terminalScore = 0;
     if (search::isTerminal(board, ply, terminalScore))
@@ -378,22 +604,19 @@ int MinimaxSearch::qsearch(Board& board, int alpha, int beta, int ply, const Sea
     // On limite la profondeur de qsearch pour éviter l'explosion combinatoire
     // même sur les coups tactiques (ex: 4 plies max de qsearch)
     // Mais ici on n'a pas de paramètre depth_q. On suppose que les coups tactiques s'épuisent.
-    // Pour sécurité, on peut checker ctx.isTimeUp()
-    if (ctx.isTimeUp())
-        return alpha;
-
     auto moves = CandidateGenerator::generateTactical(board, ctx.rules, toMove);
 
     // Tri basique : captures d'abord ?
     // Pour l'instant on fait confiance à l'ordre de génération (qui est spatial)
 
     for (const auto& m : moves) {
-        auto pr = board.tryPlay(m, ctx.rules);
-        if (!pr.success)
+        if (!board.makeMove(m, ctx.rules))
             continue;
 
         int score = -qsearch(board, -beta, -alpha, ply + 1, ctx);
-        board.undo();
+        board.unmakeMove();
+        if (ctx.stopped())
+            return 0;
 
         if (score >= beta)
             return beta;
@@ -419,7 +642,9 @@ bool MinimaxSearch::runDepthWithWindow(int depth, Board& board, const RuleSet& r
     std::optional<Move> ttRootMove;
     int ttScore = 0;
     TranspositionTable::Flag ttFlag = TranspositionTable::Flag::Exact;
-    const bool ttHit = search::ttProbe(tt, board, depth, alpha, beta, ttScore, ttRootMove, ttFlag);
+    const bool ttHit = search::ttProbe(*tt, board, rules, depth, alpha, beta, ttScore, ttRootMove, ttFlag);
+    if (!ttRootMove)
+        ttRootMove = rootHint_; // VCT à vérifier : examiné en premier
     if (ttHit) {
         ctx.recordTTHit();
 
@@ -439,18 +664,23 @@ bool MinimaxSearch::runDepthWithWindow(int depth, Board& board, const RuleSet& r
     int depthBestScore = -search::INF;
     std::vector<Move> depthPV;
     int bestMoveIndex = -1;
+    // Nodes spent under each root move, for the time manager
+    auto nodesSoFar = [&ctx] { return ctx.stats ? ctx.stats->nodes + ctx.stats->qnodes : 0; };
+    long long iterationNodes = 0;
+    long long bestMoveNodes = 0;
 
     for (size_t i = 0; i < ordered.size(); ++i) {
         if (ctx.isTimeUp())
             break;
 
         const Move& m = ordered[i];
-        auto pr = board.tryPlay(m, rules);
-        if (!pr.success)
+        if (!board.makeMove(m, rules))
             continue;
+        tt->prefetch(search::ttKey(board, rules));
 
         std::vector<Move> childPV;
         int childScore;
+        const long long nodesBefore = nodesSoFar();
 
         if (i == 0) {
             // PVS: premier enfant en fenêtre pleine
@@ -466,10 +696,15 @@ bool MinimaxSearch::runDepthWithWindow(int depth, Board& board, const RuleSet& r
         }
 
         const int score = -childScore;
-        board.undo();
+        board.unmakeMove();
+        if (ctx.stopped())
+            break; // this move was not fully searched
+        const long long moveNodes = nodesSoFar() - nodesBefore;
+        iterationNodes += moveNodes;
 
         if (score > depthBestScore) {
             depthBestScore = score;
+            bestMoveNodes = moveNodes;
             depthBest = m;
             bestMoveIndex = static_cast<int>(i);
             depthPV.clear();
@@ -495,22 +730,29 @@ bool MinimaxSearch::runDepthWithWindow(int depth, Board& board, const RuleSet& r
             bestMoveIndex + 1, static_cast<int>(ordered.size()));
     }
 
-    // Timeout au milieu mais on a un meilleur ? → renvoyer le partiel
+    // Itération interrompue : seuls les coups entièrement cherchés comptent. Leur meilleur est
+    // retenu s'il bat la fenêtre (un fail-low ne dit rien) ou si aucune itération n'a abouti.
+    if (ctx.stopped()) {
+        if (depthBest && (!best || depthBestScore > alpha0)) {
+            best = depthBest;
+            pv = std::move(depthPV);
+        }
+        return false;
+    }
     if (!depthBest)
         return false;
 
     best = depthBest;
     bestScore = depthBestScore;
     pv = std::move(depthPV);
+    rootBestNodeShare_ = iterationNodes ? static_cast<double>(bestMoveNodes) / static_cast<double>(iterationNodes) : 0.0;
 
     // Déterminer le flag TT vs fenêtre d’origine
     TranspositionTable::Flag storeFlag = (bestScore <= alpha0) ? TranspositionTable::Flag::Upper : (bestScore >= beta0) ? TranspositionTable::Flag::Lower
                                                                                                                         : TranspositionTable::Flag::Exact;
 
-    // Option: ne pas stocker si timeUp (pour éviter d’empoisonner la TT)
-    if (!ctx.isTimeUp()) {
-        search::ttStore(tt, board, depth, bestScore, storeFlag, best);
-    }
+    // Itération complète : le résultat est sûr même si le temps vient de s'écouler
+    search::ttStore(*tt, board, rules, depth, bestScore, storeFlag, best);
 
     return true;
 }
@@ -4,7 +4,7 @@
 #include <iostream>
 #include <stdexcept>
 
-namespace gomoku::ai {
+namespace gomoku::inline GOMOKU_SIZE_NS::ai {
 
 MinimaxSearchEngine::MinimaxSearchEngine()
     : searchImpl_(SearchConfig {})
@@ -18,6 +18,12 @@ MinimaxSearchEngine::MinimaxSearchEngine(const SearchConfig& config)
 {
 }
 
+MinimaxSearchEngine::MinimaxSearchEngine(const SearchConfig& config, const eval::EvalConfig& evalConfig)
+    : searchImpl_(config, evalConfig)
+    , config_(config)
+{
+}
+
 void MinimaxSearchEngine::setTimeLimit(int milliseconds)
 {
     config_.timeBudgetMs = milliseconds;
@@ -33,9 +39,28 @@ void MinimaxSearchEngine::setDepthLimit(int maxDepth)
 void MinimaxSearchEngine::setTranspositionTableSize(size_t bytes)
 {
     config_.ttBytes = bytes;
+    config_.sharedTT = false; // taille explicite : table privée
     searchImpl_.setTranspositionTableSize(bytes);
 }
 
+void MinimaxSearchEngine::setThreadCount(int threads)
+{
+    config_.threads = threads < 1 ? 1 : threads;
+    searchImpl_.setThreadCount(threads);
+}
+
+void MinimaxSearchEngine::setGameClock(const GameClock& clock)
+{
+    config_.clock = clock;
+    searchImpl_.setGameClock(clock);
+}
+
+void MinimaxSearchEngine::setNodeBudget(unsigned long long nodes)
+{
+    config_.nodeBudget = nodes;
+    searchImpl_.setNodeBudget(nodes);
+}
+
 std::optional<Move> MinimaxSearchEngine::findBestMove(const IBoardView& board, const RuleSet& rules, SearchStats* stats)
 {
     // Convert IBoardView to concrete Board for MinimaxSearch class
@@ -60,6 +85,28 @@ std::optional<Move> MinimaxSearchEngine::suggestMove(const IBoardView& board, co
     return res;
 }
 
+void MinimaxSearchEngine::stop()
+{
+    searchImpl_.stop();
+}
+
+void MinimaxSearchEngine::startPondering(const IBoardView& board, const RuleSet& rules)
+{
+    searchImpl_.startPonder(boardFromView(board), rules);
+}
+
+std::optional<Move> MinimaxSearchEngine::ponderHit(int timeMs, SearchStats* stats)
+{
+    auto result = searchImpl_.ponderHit(timeMs, stats);
+    lastStats_ = stats ? *stats : SearchStats {};
+    return result;
+}
+
+void MinimaxSearchEngine::stopPondering()
+{
+    searchImpl_.stopPonder();
+}
+
 int MinimaxSearchEngine::evaluatePosition(const IBoardView& board, Player perspective) const
 {
     // Pas de copie, juste un cast de référence/pointeur
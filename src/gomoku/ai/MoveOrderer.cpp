@@ -5,17 +5,16 @@
 #include <algorithm>
 #include <limits>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 MoveOrderer::ScopedPlay::ScopedPlay(Board& board, const Move& move, const RuleSet& rules)
     : b(board)
 {
-    auto pr = b.tryPlay(move, rules);
-    ok = pr.success;
+    ok = b.makeMove(move, rules);
 }
 MoveOrderer::ScopedPlay::~ScopedPlay()
 {
     if (ok)
-        b.undo();
+        b.unmakeMove();
 }
 
 void MoveOrderer::ensureCapacity(int maxPly)
@@ -0,0 +1,388 @@
+// NnueNetwork.cpp - Quantized evaluation network: incremental accumulators, SIMD kernels
+#include "gomoku/ai/NnueNetwork.hpp"
+#include "gomoku/core/Board.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GOMOKU_NNUE_X86 1
+#endif
+
+namespace gomoku::inline GOMOKU_SIZE_NS::eval {
+
+namespace {
+    constexpr int H = NnueWeights::HIDDEN;
+    constexpr int CELLS = NnueWeights::CELLS;
+    constexpr int MAX_PAIRS = NnueWeights::MAX_PAIRS;
+    constexpr int16_t ACTIVATION_MAX = 127;
+    constexpr int64_t SCORE_LIMIT = 500'000; // sous les scores de mat de la recherche
+    constexpr int REFRESH_BATCH = 16; // lignes ajoutées par appel du noyau
+    static_assert(H % 16 == 0, "kernels process 16 accumulators at a time");
+
+    constexpr char FILE_MAGIC[4] = { 'G', 'N', 'U', 'E' };
+    constexpr uint32_t FILE_VERSION = 1;
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t boardSize;
+        uint32_t hidden;
+        uint32_t maxPairs;
+        int32_t outputBias;
+        int32_t outputScale;
+    };
+
+    inline int side(Player p) noexcept { return p == Player::Black ? 0 : 1; }
+    inline int cellOf(Pos p) noexcept { return p.y * BOARD_SIZE + p.x; }
+    // Input rows as seen from 'perspective'
+    inline int stoneFeature(Player stone, Player perspective, int cell) noexcept
+    {
+        return (stone == perspective ? 0 : CELLS) + cell;
+    }
+    inline int pairFeature(bool own, int pairs) noexcept
+    {
+        return 2 * CELLS + (own ? 0 : MAX_PAIRS + 1) + std::clamp(pairs, 0, MAX_PAIRS);
+    }
+
+    // ---- Kernels -----------------------------------------------------------
+    // update: dst = src + sum(adds) - sum(subs), HIDDEN lanes, int16 wrap-around (dst may be src)
+    // output: dot product of clamp(acc, 0, 127) for both perspectives with the output weights
+    using UpdateFn = void (*)(int16_t* dst, const int16_t* src, const int16_t* const* adds, int nAdd, const int16_t* const* subs, int nSub);
+    using OutputFn = int32_t (*)(const int16_t* us, const int16_t* them, const int8_t* w);
+
+    void updateScalar(int16_t* dst, const int16_t* src, const int16_t* const* adds, int nAdd, const int16_t* const* subs, int nSub)
+    {
+        for (int i = 0; i < H; ++i) {
+            int v = src[i];
+            for (int a = 0; a < nAdd; ++a)
+                v += adds[a][i];
+            for (int s = 0; s < nSub; ++s)
+                v -= subs[s][i];
+            dst[i] = static_cast<int16_t>(v);
+        }
+    }
+
+    int32_t outputScalar(const int16_t* us, const int16_t* them, const int8_t* w)
+    {
+        int32_t sum = 0;
+        for (int i = 0; i < H; ++i) {
+            sum += std::clamp<int16_t>(us[i], 0, ACTIVATION_MAX) * w[i];
+            sum += std::clamp<int16_t>(them[i], 0, ACTIVATION_MAX) * w[H + i];
+        }
+        return sum;
+    }
+
+#ifdef GOMOKU_NNUE_X86
+    __attribute__((target("avx2"))) void updateAvx2(int16_t* dst, const int16_t* src, const int16_t* const* adds, int nAdd, const int16_t* const* subs, int nSub)
+    {
+        for (int i = 0; i < H; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            for (int a = 0; a < nAdd; ++a)
+                v = _mm256_add_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(adds[a] + i)));
+            for (int s = 0; s < nSub; ++s)
+                v = _mm256_sub_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(subs[s] + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+        }
+    }
+
+    __attribute__((target("avx2"))) int32_t outputAvx2(const int16_t* us, const int16_t* them, const int8_t* w)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i top = _mm256_set1_epi16(ACTIVATION_MAX);
+        __m256i sum = zero;
+        for (int k = 0; k < 2; ++k) {
+            const int16_t* acc = k == 0 ? us : them;
+            const int8_t* row = w + k * H;
+            for (int i = 0; i < H; i += 16) {
+                const __m256i a = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i)), zero), top);
+                const __m256i b = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, b));
+            }
+        }
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+        return _mm_cvtsi128_si32(s);
+    }
+
+    __attribute__((target("sse4.1"))) void updateSse41(int16_t* dst, const int16_t* src, const int16_t* const* adds, int nAdd, const int16_t* const* subs, int nSub)
+    {
+        for (int i = 0; i < H; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            for (int a = 0; a < nAdd; ++a)
+                v = _mm_add_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(adds[a] + i)));
+            for (int s = 0; s < nSub; ++s)
+                v = _mm_sub_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(subs[s] + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+        }
+    }
+
+    __attribute__((target("sse4.1"))) int32_t outputSse41(const int16_t* us, const int16_t* them, const int8_t* w)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i top = _mm_set1_epi16(ACTIVATION_MAX);
+        __m128i sum = zero;
+        for (int k = 0; k < 2; ++k) {
+            const int16_t* acc = k == 0 ? us : them;
+            const int8_t* row = w + k * H;
+            for (int i = 0; i < H; i += 8) {
+                const __m128i a = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i)), zero), top);
+                const __m128i b = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i)));
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(a, b));
+            }
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return _mm_cvtsi128_si32(sum);
+    }
+#endif
+
+    struct Kernels {
+        UpdateFn update;
+        OutputFn output;
+        const char* name;
+    };
+
+    // Best kernels of this CPU, chosen once
+    const Kernels& kernels()
+    {
+        static const Kernels k = [] {
+#ifdef GOMOKU_NNUE_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return Kernels { updateAvx2, outputAvx2, "avx2" };
+            if (__builtin_cpu_supports("sse4.1"))
+                return Kernels { updateSse41, outputSse41, "sse4.1" };
+#endif
+            return Kernels { updateScalar, outputScalar, "scalar" };
+        }();
+        return k;
+    }
+
+    // ---- Accumulators ------------------------------------------------------
+    struct AccEntry {
+        uint64_t key = 0; // Zobrist de la position
+        std::array<int, 2> pairs {}; // paires capturées (Noir, Blanc)
+        std::array<std::array<int16_t, H>, 2> acc {}; // perspective Noir, Blanc
+    };
+
+    // Per-thread accumulators along the undo stack of the last board evaluated:
+    // entries[i] is the position after base + i moves of its history
+    struct AccStack {
+        uint64_t net = 0;
+        std::size_t base = 0;
+        std::vector<AccEntry> entries;
+    };
+    thread_local AccStack tlsStack;
+
+    std::atomic<uint64_t> nextNetworkId { 1 };
+
+    inline const int16_t* row(const NnueWeights& w, int feature) noexcept
+    {
+        return w.featureWeights.data() + static_cast<std::size_t>(feature) * H;
+    }
+
+    void refresh(const NnueWeights& w, const Board& board, AccEntry& e, UpdateFn update)
+    {
+        const auto caps = board.capturedPairs();
+        e.key = board.zobristKey();
+        e.pairs = { caps.black, caps.white };
+        const BoardState& st = board.rawState();
+        for (const Player p : { Player::Black, Player::White }) {
+            int16_t* dst = e.acc[side(p)].data();
+            update(dst, w.featureBias.data(), nullptr, 0, nullptr, 0);
+            std::array<const int16_t*, REFRESH_BATCH> rows {};
+            int n = 0;
+            auto push = [&](int feature) {
+                rows[n++] = row(w, feature);
+                if (n == REFRESH_BATCH) {
+                    update(dst, dst, rows.data(), n, nullptr, 0);
+                    n = 0;
+                }
+            };
+            for (const Pos& pos : board.occupiedPositions())
+                push(stoneFeature(st.getCell(pos) == Cell::Black ? Player::Black : Player::White, p, cellOf(pos)));
+            push(pairFeature(true, e.pairs[side(p)]));
+            push(pairFeature(false, e.pairs[side(opponent(p))]));
+            update(dst, dst, rows.data(), n, nullptr, 0);
+        }
+    }
+
+    // 'to' = 'from' after move d: the stone placed, the stones captured, the mover's pair count
+    void applyDelta(const NnueWeights& w, const AccEntry& from, AccEntry& to, const Board::HistoryDelta& d, uint64_t keyAfter, UpdateFn update)
+    {
+        const Player mover = d.move.by;
+        const Player victim = opponent(mover);
+        const int gained = d.capturedCount / 2;
+        to.key = keyAfter;
+        to.pairs = from.pairs;
+        to.pairs[side(mover)] += gained;
+        for (const Player p : { Player::Black, Player::White }) {
+            std::array<const int16_t*, 2> adds {};
+            std::array<const int16_t*, capture::MAX_CAPTURED_STONES + 1> subs {};
+            int nAdd = 0, nSub = 0;
+            adds[nAdd++] = row(w, stoneFeature(mover, p, cellOf(d.move.pos)));
+            for (int i = 0; i < d.capturedCount; ++i)
+                subs[nSub++] = row(w, stoneFeature(victim, p, cellOf(d.captured[i])));
+            if (gained > 0) {
+                subs[nSub++] = row(w, pairFeature(mover == p, from.pairs[side(mover)]));
+                adds[nAdd++] = row(w, pairFeature(mover == p, to.pairs[side(mover)]));
+            }
+            update(to.acc[side(p)].data(), from.acc[side(p)].data(), adds.data(), nAdd, subs.data(), nSub);
+        }
+    }
+
+    int output(const NnueWeights& w, const AccEntry& e, Player toPlay, Player perspective, OutputFn out)
+    {
+        const int32_t dot = out(e.acc[side(toPlay)].data(), e.acc[side(opponent(toPlay))].data(), w.outputWeights.data());
+        const int64_t v = std::clamp((static_cast<int64_t>(dot) + w.outputBias) * w.outputScale / 65536, -SCORE_LIMIT, SCORE_LIMIT);
+        return static_cast<int>(perspective == toPlay ? v : -v);
+    }
+
+    template <class T>
+    bool writeArray(std::ofstream& out, const std::vector<T>& v)
+    {
+        return static_cast<bool>(out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T))));
+    }
+
+    template <class T>
+    bool readArray(std::ifstream& in, std::vector<T>& v)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T))));
+    }
+} // namespace
+
+NnueWeights NnueWeights::zero()
+{
+    NnueWeights w;
+    w.featureWeights.assign(static_cast<std::size_t>(INPUTS) * HIDDEN, 0);
+    w.featureBias.assign(HIDDEN, 0);
+    w.outputWeights.assign(2 * HIDDEN, 0);
+    return w;
+}
+
+bool NnueWeights::valid() const noexcept
+{
+    return featureWeights.size() == static_cast<std::size_t>(INPUTS) * HIDDEN
+        && featureBias.size() == static_cast<std::size_t>(HIDDEN)
+        && outputWeights.size() == static_cast<std::size_t>(2 * HIDDEN);
+}
+
+bool NnueWeights::save(const std::string& path) const
+{
+    if (!valid())
+        return false;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+    FileHeader h {};
+    std::memcpy(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    h.version = FILE_VERSION;
+    h.boardSize = static_cast<uint32_t>(BOARD_SIZE);
+    h.hidden = HIDDEN;
+    h.maxPairs = MAX_PAIRS;
+    h.outputBias = outputBias;
+    h.outputScale = outputScale;
+    return out.write(reinterpret_cast<const char*>(&h), sizeof(h))
+        && writeArray(out, featureBias) && writeArray(out, featureWeights) && writeArray(out, outputWeights);
+}
+
+std::optional<NnueWeights> NnueWeights::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return std::nullopt;
+    const auto size = static_cast<std::size_t>(in.tellg());
+    in.seekg(0);
+    NnueWeights w = zero();
+    const std::size_t expected = sizeof(FileHeader) + (w.featureBias.size() + w.featureWeights.size()) * sizeof(int16_t) + w.outputWeights.size();
+    FileHeader h {};
+    if (size != expected || !in.read(reinterpret_cast<char*>(&h), sizeof(h)))
+        return std::nullopt;
+    if (std::memcmp(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || h.version != FILE_VERSION
+        || h.boardSize != static_cast<uint32_t>(BOARD_SIZE) || h.hidden != HIDDEN || h.maxPairs != MAX_PAIRS)
+        return std::nullopt;
+    w.outputBias = h.outputBias;
+    w.outputScale = h.outputScale;
+    if (!readArray(in, w.featureBias) || !readArray(in, w.featureWeights) || !readArray(in, w.outputWeights))
+        return std::nullopt;
+    return w;
+}
+
+NnueNetwork::NnueNetwork(NnueWeights weights)
+    : w_(std::move(weights))
+    , id_(nextNetworkId.fetch_add(1, std::memory_order_relaxed))
+{
+    if (!w_.valid())
+        w_ = NnueWeights::zero();
+}
+
+std::shared_ptr<const NnueNetwork> NnueNetwork::open(const std::string& path)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const NnueNetwork>> cache;
+    std::lock_guard lock(mutex);
+    if (auto net = cache[path].lock())
+        return net;
+    auto weights = NnueWeights::load(path);
+    if (!weights) {
+        cache.erase(path);
+        return nullptr;
+    }
+    auto net = std::make_shared<const NnueNetwork>(std::move(*weights));
+    cache[path] = net;
+    return net;
+}
+
+const char* NnueNetwork::simdName() noexcept
+{
+    return kernels().name;
+}
+
+int NnueNetwork::evaluate(const Board& board, Player perspective) const noexcept
+{
+    if (board.status() == GameStatus::Draw)
+        return 0;
+    const Kernels& k = kernels();
+    AccStack& s = tlsStack;
+    if (s.net != id_) {
+        s.net = id_;
+        s.entries.clear();
+    }
+
+    // Deepest known position on this board's undo stack
+    const std::size_t n = board.historySize();
+    auto keyAt = [&](std::size_t d) { return d == n ? board.zobristKey() : board.historyDelta(d).keyBefore; };
+    std::ptrdiff_t top = -1;
+    if (!s.entries.empty() && s.base <= n) {
+        top = static_cast<std::ptrdiff_t>(std::min(s.entries.size() - 1, n - s.base));
+        while (top >= 0 && s.entries[static_cast<std::size_t>(top)].key != keyAt(s.base + static_cast<std::size_t>(top)))
+            --top;
+    }
+    if (top < 0) {
+        s.base = n;
+        s.entries.resize(1);
+        refresh(w_, board, s.entries[0], k.update);
+    } else {
+        s.entries.resize(n - s.base + 1);
+        for (std::size_t d = s.base + static_cast<std::size_t>(top); d < n; ++d)
+            applyDelta(w_, s.entries[d - s.base], s.entries[d - s.base + 1], board.historyDelta(d), keyAt(d + 1), k.update);
+    }
+    return output(w_, s.entries.back(), board.toPlay(), perspective, k.output);
+}
+
+int NnueNetwork::evaluateFull(const Board& board, Player perspective) const noexcept
+{
+    if (board.status() == GameStatus::Draw)
+        return 0;
+    AccEntry e;
+    refresh(w_, board, e, updateScalar);
+    return output(w_, e, board.toPlay(), perspective, outputScalar);
+}
+
+} // namespace gomoku::eval
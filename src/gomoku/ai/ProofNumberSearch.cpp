@@ -0,0 +1,324 @@
+// ProofNumberSearch.cpp - Depth-first proof-number solver (df-pn)
+#include "gomoku/ai/ProofNumberSearch.hpp"
+#include "gomoku/ai/SearchHelpers.hpp"
+#include "gomoku/core/Bitboard.hpp"
+#include "gomoku/core/Board.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+namespace {
+    constexpr uint64_t WHITE_ATTACKS_SALT = 0xD1B54A32D192ED03ull; // nœuds OR/AND inversés
+    constexpr uint32_t POLL_MASK = 1023; // horloge et arrêt lus tous les 1024 nœuds
+
+    constexpr bool isWin(GameStatus s) noexcept
+    {
+        return s == GameStatus::WinByAlign || s == GameStatus::WinByCapture;
+    }
+
+    inline uint32_t saturatedAdd(uint32_t a, uint32_t b, uint32_t inf) noexcept
+    {
+        return (a >= inf - b) ? inf : a + b;
+    }
+
+    // Threshold given to the best child: beyond the runner-up by 1 + 1/4, so the search does
+    // not switch back and forth between two children of close proof numbers
+    inline uint32_t grown(uint32_t second, uint32_t inf) noexcept
+    {
+        return second >= inf ? inf : static_cast<uint32_t>(std::min<uint64_t>(inf, uint64_t(second) + 1 + second / 4));
+    }
+} // namespace
+
+ProofNumberSearch::ProofNumberSearch(const ProofSearchConfig& cfg)
+    : cfg_(cfg)
+{
+}
+
+void ProofNumberSearch::setMemoryLimit(std::size_t bytes)
+{
+    cfg_.tableBytes = bytes;
+    table_.clear();
+    table_.shrink_to_fit();
+}
+
+void ProofNumberSearch::clear()
+{
+    table_.clear();
+    table_.shrink_to_fit();
+}
+
+ProofResult ProofNumberSearch::solve(const IBoardView& view, const RuleSet& rules)
+{
+    stopRequested_.store(false, std::memory_order_relaxed);
+    const auto start = SearchDeadline::clock::now();
+    timed_ = cfg_.timeLimitMs > 0;
+    deadline_.set(timed_ ? start + std::chrono::milliseconds(cfg_.timeLimitMs) : SearchDeadline::clock::time_point::max());
+
+    Board board = static_cast<const Board&>(view);
+    const Player side = board.toPlay();
+
+    // Win of the side to move, then a loss with the nodes left
+    ProofResult res = run(board, rules, side, cfg_.nodeLimit);
+    if (res.value == ProofValue::Unknown && !aborted_) {
+        const unsigned long long used = static_cast<unsigned long long>(res.nodes);
+        if (!cfg_.nodeLimit || used < cfg_.nodeLimit) {
+            ProofResult loss = run(board, rules, opponent(side), cfg_.nodeLimit ? cfg_.nodeLimit - used : 0);
+            loss.nodes += res.nodes;
+            res = std::move(loss);
+        }
+    }
+    res.timeMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(SearchDeadline::clock::now() - start).count());
+    return res;
+}
+
+ProofResult ProofNumberSearch::prove(Board& board, const RuleSet& rules, Player attacker)
+{
+    stopRequested_.store(false, std::memory_order_relaxed);
+    const auto start = SearchDeadline::clock::now();
+    timed_ = cfg_.timeLimitMs > 0;
+    deadline_.set(timed_ ? start + std::chrono::milliseconds(cfg_.timeLimitMs) : SearchDeadline::clock::time_point::max());
+
+    ProofResult res = run(board, rules, attacker, cfg_.nodeLimit);
+    res.timeMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(SearchDeadline::clock::now() - start).count());
+    return res;
+}
+
+ProofResult ProofNumberSearch::run(Board& board, const RuleSet& rules, Player attacker, unsigned long long nodeLimit)
+{
+    if (table_.empty()) {
+        std::size_t buckets = std::max<std::size_t>(cfg_.tableBytes / (sizeof(Entry) * BUCKET), 1);
+        buckets = std::bit_floor(buckets);
+        table_.assign(buckets * BUCKET, Entry {});
+        generation_ = 0;
+    }
+    // Nouvelle génération : les entrées des appels précédents deviennent libres
+    if (++generation_ == 0) {
+        std::fill(table_.begin(), table_.end(), Entry {});
+        generation_ = 1;
+    }
+
+    rules_ = &rules;
+    attacker_ = attacker;
+    nodeLimit_ = nodeLimit;
+    nodes_ = 0;
+    aborted_ = false;
+
+    ProofResult res;
+    if (board.status() != GameStatus::Ongoing) {
+        res.nodes = 0;
+        return res;
+    }
+
+    const Bounds root = mid(board, nodeKey(board), PN_INF, PN_INF, 0);
+    if (root.pn == 0) {
+        res.value = board.toPlay() == attacker ? ProofValue::Win : ProofValue::Loss;
+        extractLine(board, res.line);
+    }
+    res.nodes = nodes_;
+    return res;
+}
+
+ProofNumberSearch::Bounds ProofNumberSearch::mid(Board& board, uint64_t key, uint32_t thPn, uint32_t thDn, int ply)
+{
+    const Entry* known = lookup(key);
+    if (known && (known->pn >= thPn || known->dn >= thDn))
+        return { known->pn, known->dn };
+    if (!enterNode())
+        return known ? Bounds { known->pn, known->dn } : Bounds { 1, 1 };
+    const bool orNode = board.toPlay() == attacker_;
+    const long long startNodes = nodes_;
+
+    struct Child {
+        Move move;
+        uint64_t key;
+        Bounds b;
+        uint32_t work;
+        bool fixed; // terminal ou au-delà de maxPly : jamais développé
+    };
+    std::vector<Child> kids;
+    const std::vector<Move> moves = children(board, orNode);
+    kids.reserve(moves.size());
+
+    // Expansion : une fin de partie tranche le nœud sur-le-champ
+    for (const Move& m : moves) {
+        if (!board.makeMove(m, *rules_))
+            continue; // double-trois interdit
+        const GameStatus st = board.status();
+        if (isWin(st)) {
+            board.unmakeMove();
+            // Le joueur qui vient de jouer gagne : preuve en OR, réfutation en AND
+            const Bounds b = orNode ? Bounds { 0, PN_INF } : Bounds { PN_INF, 0 };
+            store(key, b, 1, m.pos.toIndex());
+            return b;
+        }
+        Child c { m, 0, { 1, 1 }, 0, false };
+        if (st == GameStatus::Draw || ply + 1 >= cfg_.maxPly) {
+            c.b = { PN_INF, 0 };
+            c.fixed = true;
+        } else {
+            c.key = nodeKey(board);
+            if (const Entry* e = lookup(c.key)) {
+                c.b = { e->pn, e->dn };
+                c.work = e->work;
+            }
+        }
+        board.unmakeMove();
+        kids.push_back(c);
+    }
+
+    Bounds self { PN_INF, 0 }; // plus de coup : l'attaquant ne gagne pas
+    std::size_t best = 0;
+    while (!kids.empty()) {
+        // OR : pn = min, dn = somme ; AND : l'inverse
+        uint32_t minVal = PN_INF, second = PN_INF, sum = 0;
+        best = 0;
+        for (std::size_t i = 0; i < kids.size(); ++i) {
+            const uint32_t v = orNode ? kids[i].b.pn : kids[i].b.dn;
+            const uint32_t w = orNode ? kids[i].b.dn : kids[i].b.pn;
+            sum = saturatedAdd(sum, w, PN_INF);
+            if (v < minVal) {
+                second = minVal;
+                minVal = v;
+                best = i;
+            } else if (v < second) {
+                second = v;
+            }
+        }
+        self = orNode ? Bounds { minVal, sum } : Bounds { sum, minVal };
+        if (self.pn >= thPn || self.dn >= thDn || aborted_)
+            break;
+
+        Child& c = kids[best];
+        uint32_t cThPn, cThDn;
+        if (orNode) {
+            cThPn = std::min(thPn, grown(second, PN_INF));
+            cThDn = thDn - self.dn + c.b.dn;
+        } else {
+            cThDn = std::min(thDn, grown(second, PN_INF));
+            cThPn = thPn - self.pn + c.b.pn;
+        }
+        const long long before = nodes_;
+        board.makeMove(c.move, *rules_);
+        c.b = mid(board, c.key, cThPn, cThDn, ply + 1);
+        board.unmakeMove();
+        c.work += static_cast<uint32_t>(nodes_ - before);
+    }
+
+    // Coup retenu : l'enfant prouvé en OR, la parade la plus coûteuse d'un AND prouvé
+    if (!orNode && self.pn == 0)
+        best = static_cast<std::size_t>(std::max_element(kids.begin(), kids.end(), [](const Child& a, const Child& b) { return a.work < b.work; }) - kids.begin());
+    const uint16_t bestIdx = kids.empty() ? 0 : kids[best].move.pos.toIndex();
+    store(key, self, static_cast<uint32_t>(std::min<long long>(nodes_ - startNodes, UINT32_MAX)), bestIdx);
+    return self;
+}
+
+std::vector<Move> ProofNumberSearch::children(const Board& board, bool orNode) const
+{
+    const Player me = board.toPlay();
+    std::vector<Move> out = CandidateGenerator::generateTactical(board, *rules_, me);
+    // En défense, les cases tactiques de l'attaquant (ses cinq, ses captures) d'abord
+    if (!orNode)
+        for (const Move& m : CandidateGenerator::generateTactical(board, *rules_, opponent(me)))
+            out.push_back(Move { m.pos, me });
+
+    Bitboard seen;
+    std::size_t n = 0;
+    for (const Move& m : out) {
+        const int id = m.pos.toIndex();
+        if (!seen.test(id)) {
+            seen.set(id);
+            out[n++] = m;
+        }
+    }
+    out.resize(n);
+    for (const Move& m : CandidateGenerator::generate(board, *rules_, me, orNode ? cfg_.attackMoves : cfg_.defenceMoves)) {
+        const int id = m.pos.toIndex();
+        if (!seen.test(id)) {
+            seen.set(id);
+            out.push_back(Move { m.pos, me });
+        }
+    }
+    return out;
+}
+
+bool ProofNumberSearch::enterNode()
+{
+    if (aborted_)
+        return false;
+    ++nodes_;
+    if (nodeLimit_ && static_cast<unsigned long long>(nodes_) > nodeLimit_) {
+        aborted_ = true;
+        return false;
+    }
+    if ((nodes_ & POLL_MASK) == 0) {
+        if (stopRequested_.load(std::memory_order_relaxed) || (timed_ && deadline_.passed(SearchDeadline::clock::now())))
+            aborted_ = true;
+    }
+    return !aborted_;
+}
+
+uint64_t ProofNumberSearch::nodeKey(const Board& board) const noexcept
+{
+    const uint64_t key = search::ttKey(board, *rules_) ^ (attacker_ == Player::White ? WHITE_ATTACKS_SALT : 0);
+    return key ? key : 1; // 0 = entrée vide
+}
+
+const ProofNumberSearch::Entry* ProofNumberSearch::lookup(uint64_t key) const noexcept
+{
+    const std::size_t base = (key & (table_.size() / BUCKET - 1)) * BUCKET;
+    for (int i = 0; i < BUCKET; ++i) {
+        const Entry& e = table_[base + i];
+        if (e.key == key && e.generation == generation_)
+            return &e;
+    }
+    return nullptr;
+}
+
+void ProofNumberSearch::store(uint64_t key, Bounds b, uint32_t work, uint16_t best) noexcept
+{
+    const std::size_t base = (key & (table_.size() / BUCKET - 1)) * BUCKET;
+    Entry* victim = nullptr;
+    for (int i = 0; i < BUCKET; ++i) {
+        Entry& e = table_[base + i];
+        if (e.generation != generation_ || e.key == key) {
+            victim = &e;
+            if (e.key == key)
+                break;
+            continue;
+        }
+        // Remplacement : le plus petit sous-arbre part
+        if (!victim || (victim->generation == generation_ && e.work < victim->work))
+            victim = &e;
+    }
+    *victim = Entry { key, b.pn, b.dn, work, best, generation_ };
+}
+
+void ProofNumberSearch::extractLine(Board& board, std::vector<Move>& line)
+{
+    int played = 0;
+    for (int ply = 0; ply <= cfg_.maxPly; ++ply) {
+        const uint64_t key = nodeKey(board);
+        const Entry* e = lookup(key);
+        if (!e || e->pn != 0) {
+            // Évincée de la table : on la reprouve (sous-arbre déjà prouvé, donc court)
+            if (aborted_ || mid(board, key, PN_INF, PN_INF, ply).pn != 0)
+                break;
+            e = lookup(key);
+            if (!e)
+                break;
+        }
+        const Move m { Pos::fromIndex(e->best), board.toPlay() };
+        if (!board.makeMove(m, *rules_))
+            break;
+        line.push_back(m);
+        ++played;
+        if (board.status() != GameStatus::Ongoing)
+            break;
+    }
+    while (played--)
+        board.unmakeMove();
+}
+
+} // namespace gomoku
@@ -1,8 +1,9 @@
 // SearchHelpers.cpp - Utility functions for minimax search
 #include "gomoku/ai/SearchHelpers.hpp"
 #include "gomoku/core/Board.hpp"
+#include "gomoku/core/Zobrist.hpp"
 
-namespace gomoku::search {
+namespace gomoku::inline GOMOKU_SIZE_NS::search {
 
 bool isTerminal(const Board& board, int ply, int& outScore) noexcept
 {
@@ -24,27 +25,38 @@ bool isTerminal(const Board& board, int ply, int& outScore) noexcept
     return false;
 }
 
-bool ttProbe(const TranspositionTable& tt, const Board& board, int depth, int alpha, int beta, int& outScore, std::optional<Move>& ttMove, TranspositionTable::Flag& outFlag) noexcept
+uint64_t ttKey(const Board& board, const RuleSet& rules) noexcept
+{
+    return board.zobristKey() ^ zobrist::rules(rules);
+}
+
+uint64_t ttFingerprint(const RuleSet& rules) noexcept
+{
+    // A piece key changes with any reseed of the tables
+    return zobrist::rules(rules) ^ zobrist::piece(Cell::White, static_cast<zobrist::FlatIdx>(BOARD_SIZE * BOARD_SIZE - 1));
+}
+
+bool ttProbe(const TranspositionTable& tt, const Board& board, const RuleSet& rules, int depth, int alpha, int beta, int& outScore, std::optional<Move>& ttMove, TranspositionTable::Flag& outFlag) noexcept
 {
     // Probe by Zobrist key; if depth is sufficient, return bound/value and best move when present.
-    const uint64_t key = board.zobristKey();
-    auto* e = tt.probe(key);
-    if (!e || e->key != key)
+    const uint64_t key = ttKey(board, rules);
+    TranspositionTable::Entry e;
+    if (!tt.probe(key, e))
         return false;
 
     // Provide TT move for ordering if valid
-    if (e->best.isValid())
-        ttMove = e->best;
+    if (e.best.isValid())
+        ttMove = e.best;
     else
         ttMove.reset();
 
     // Only use the bound/value if entry depth is sufficient
-    if (e->depth < depth)
+    if (e.depth < depth)
         return false;
 
-    outFlag = e->flag;
-    const int s = e->score;
-    switch (e->flag) {
+    outFlag = e.flag;
+    const int s = e.score;
+    switch (e.flag) {
     case TranspositionTable::Flag::Exact:
         outScore = s;
         return true;
@@ -64,10 +76,10 @@ bool ttProbe(const TranspositionTable& tt, const Board& board, int depth, int al
     return false;
 }
 
-void ttStore(TranspositionTable& tt, const Board& board, int depth, int score, TranspositionTable::Flag flag, const std::optional<Move>& best) noexcept
+void ttStore(TranspositionTable& tt, const Board& board, const RuleSet& rules, int depth, int score, TranspositionTable::Flag flag, const std::optional<Move>& best) noexcept
 {
     // Store by Zobrist key; rely on TT's internal replacement policy (prefer deeper entries).
-    const uint64_t key = board.zobristKey();
+    const uint64_t key = ttKey(board, rules);
     tt.store(key, depth, score, flag, best);
 }
 
@@ -85,11 +97,10 @@ std::optional<Move> tryImmediateWin(Board& board, const RuleSet& rules, Player t
 
     // Try each candidate speculatively
     for (const auto& m : candidates) {
-        auto pr = board.tryPlay(m, rules);
-        if (!pr.success)
+        if (!board.makeMove(m, rules))
             continue; // skip illegal candidates, don't abort early
         const auto st = board.status();
-        board.undo();
+        board.unmakeMove();
         if (st == GameStatus::WinByAlign || st == GameStatus::WinByCapture)
             return m;
     }
@@ -0,0 +1,424 @@
+// ThreatSearch.cpp - VCF/VCT threat-space solver
+#include "gomoku/ai/ThreatSearch.hpp"
+#include "gomoku/ai/SearchHelpers.hpp"
+#include "gomoku/core/Bitboard.hpp"
+#include "gomoku/core/Board.hpp"
+#include "gomoku/core/LineShapes.hpp"
+#include "gomoku/core/PatternAnalyzer.hpp"
+#include "gomoku/core/RayTables.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+namespace {
+    constexpr int LINE_REACH = 4; // un cinq passant par une case tient à moins de 4 cases d'elle
+    constexpr uint64_t VCT_SALT = 0x9E3779B97F4A7C15ull; // sépare les échecs VCT des échecs VCF
+    constexpr int PASS_DEPTH = 2; // quatres accordés au gain qui suit un trois (quatre ouvert, quatre-quatre)
+
+    inline Cell cellAt(const BoardState& st, uint16_t i) noexcept
+    {
+        return i == rays::NONE ? Cell::Wall : st.getCell(Pos::fromIndex(i));
+    }
+
+    // Stones of 'who' a line needs before a move can give it a shape of 'mask'
+    constexpr int minStonesFor(uint8_t mask) noexcept
+    {
+        return (mask & shapes::OPEN_THREE) ? 2 : (mask & (shapes::FOUR | shapes::OPEN_FOUR)) ? 3 : 4;
+    }
+
+    // Calls f(cell, d, flags) for each empty cell where a stone of 'who' makes a shape of
+    // 'mask' along d. Lines too sparse for the shape are skipped with one popcount.
+    template <class F>
+    void forEachShape(const BoardState& st, Cell who, uint8_t mask, F&& f)
+    {
+        const int minOwn = minStonesFor(mask);
+        for (int d = 0; d < lines::DIRS; ++d)
+            for (int line = 0; line < lines::COUNT; ++line) {
+                const uint32_t own = st.lineBits(who, d, line);
+                if (std::popcount(own) < minOwn)
+                    continue;
+                uint32_t near = 0;
+                for (int k = 1; k <= LINE_REACH; ++k)
+                    near |= (own << k) | (own >> k);
+                near &= st.lineEmpty(d, line);
+                for (; near; near &= near - 1) {
+                    const uint16_t i = lines::cellIndex(d, line, std::countr_zero(near));
+                    const uint8_t flags = pattern::shapesThrough(st, Pos::fromIndex(i), d, who) & mask;
+                    if (flags)
+                        f(i, d, flags);
+                }
+            }
+    }
+
+    // Empty cells where 'who' gets one of the shapes in 'mask' on some line
+    Bitboard shapeCells(const BoardState& st, Cell who, uint8_t mask)
+    {
+        Bitboard out;
+        forEachShape(st, who, mask, [&](uint16_t i, int, uint8_t) { out.set(i); });
+        return out;
+    }
+
+    // Empty cells where 'who' captures a pair (X O O _)
+    Bitboard captureCells(const Board& board, Cell who)
+    {
+        const BoardState& st = board.rawState();
+        const Cell opp = who == Cell::Black ? Cell::White : Cell::Black;
+        Bitboard out;
+        for (const Pos& p : board.occupiedPositions()) {
+            if (st.getCell(p) != who)
+                continue;
+            for (int d = 0; d < 4; ++d) {
+                const rays::CapRay& r = rays::capRaysByDir[d][BoardState::idx(p)];
+                if (cellAt(st, r.fwd[0]) == opp && cellAt(st, r.fwd[1]) == opp && cellAt(st, r.fwd[2]) == Cell::Empty)
+                    out.set(r.fwd[2]);
+                if (cellAt(st, r.bwd[0]) == opp && cellAt(st, r.bwd[1]) == opp && cellAt(st, r.bwd[2]) == Cell::Empty)
+                    out.set(r.bwd[2]);
+            }
+        }
+        return out;
+    }
+
+    // Empty cells where 'who' flanks an open pair (_ O O _), threatening to capture it
+    Bitboard captureThreatCells(const Board& board, Cell who)
+    {
+        const BoardState& st = board.rawState();
+        const Cell opp = who == Cell::Black ? Cell::White : Cell::Black;
+        Bitboard out;
+        for (const Pos& p : board.occupiedPositions()) {
+            if (st.getCell(p) != opp)
+                continue;
+            for (int d = 0; d < 4; ++d) {
+                const rays::CapRay& r = rays::capRaysByDir[d][BoardState::idx(p)];
+                if (cellAt(st, r.fwd[0]) == opp && cellAt(st, r.bwd[0]) == Cell::Empty && cellAt(st, r.fwd[1]) == Cell::Empty) {
+                    out.set(r.bwd[0]);
+                    out.set(r.fwd[1]);
+                }
+            }
+        }
+        return out;
+    }
+
+    // Pairs (stone s + a neighbour of 'who' across direction skipDir) that 'who' could lose:
+    // false if one is capturable now (one end taken by the opponent, the other empty); the
+    // ends of the pairs still open on both sides, which one opponent stone makes capturable,
+    // go to 'flanks'. Cell c (slot cs) is read as a stone of 'who'.
+    bool pairsHold(const BoardState& st, int s, int skipDir, Cell who, int cs, Bitboard& flanks)
+    {
+        auto cell = [&](int slot) { return slot == cs ? who : st.cellAtSlot(slot); };
+        for (int d = 0; d < 4; ++d) {
+            if (d == skipDir)
+                continue;
+            for (const int step : { BoardState::SLOT_STEP[d], -BoardState::SLOT_STEP[d] }) {
+                if (cell(s + step) != who)
+                    continue;
+                const int e1 = s - step, e2 = s + 2 * step; // PAD = 2 : toujours dans la grille
+                const Cell c1 = cell(e1), c2 = cell(e2);
+                if ((c1 == Cell::Empty && c2 != Cell::Empty && c2 != who && c2 != Cell::Wall)
+                    || (c2 == Cell::Empty && c1 != Cell::Empty && c1 != who && c1 != Cell::Wall))
+                    return false;
+                if (c1 == Cell::Empty && c2 == Cell::Empty) {
+                    flanks.set(BoardState::idxOfSlot(e1));
+                    flanks.set(BoardState::idxOfSlot(e2));
+                }
+            }
+        }
+        return true;
+    }
+
+    // Cells that can spoil a threat of 'who' through p: the empties of its four lines (within
+    // LINE_REACH) and the open ends of the pairs that the stones of those lines belong to
+    void addVicinity(const BoardState& st, Pos p, Cell who, Bitboard& out)
+    {
+        const int pi = BoardState::idx(p);
+        for (int d = 0; d < 4; ++d) {
+            const rays::LineNbr& nb = rays::lineNbrByDir[d][pi];
+            auto visit = [&](uint16_t i) {
+                const Pos q = Pos::fromIndex(i);
+                if (st.getCell(q) == Cell::Empty)
+                    out.set(i);
+                else if (st.getCell(q) == who)
+                    pairsHold(st, BoardState::slot(q), d, who, -1, out);
+            };
+            for (int k = 0; k < std::min<int>(nb.fwdLen, LINE_REACH); ++k)
+                visit(nb.fwd[k]);
+            for (int k = 0; k < std::min<int>(nb.bwdLen, LINE_REACH); ++k)
+                visit(nb.bwd[k]);
+        }
+        if (st.getCell(p) == who)
+            pairsHold(st, BoardState::slot(p), -1, who, -1, out);
+        else
+            out.set(static_cast<uint16_t>(pi));
+    }
+
+    // Does the five 'who' would complete at c stand? The move must be legal and no pair of
+    // the five may be capturable right after it. Open pairs of the five add their ends to
+    // 'flanks': the defender has to try them.
+    bool fiveStands(const BoardState& st, Pos c, Player who, const RuleSet& rules, Bitboard& flanks)
+    {
+        if (pattern::createsIllegalDoubleThree(st, Move { c, who }, rules))
+            return false;
+        if (!rules.capturesEnabled)
+            return true;
+        const Cell me = playerToCell(who);
+        const int cs = BoardState::slot(c);
+        auto mine = [&](int slot) { return slot == cs || st.cellAtSlot(slot) == me; };
+        for (int d = 0; d < 4; ++d) {
+            if (!(pattern::shapesThrough(st, c, d, me) & shapes::FIVE))
+                continue;
+            const int step = BoardState::SLOT_STEP[d];
+            int lo = cs;
+            while (mine(lo - step))
+                lo -= step;
+            for (int s = lo; mine(s); s += step)
+                if (!pairsHold(st, s, d, me, cs, flanks))
+                    return false;
+        }
+        return true;
+    }
+} // namespace
+
+ThreatResult ThreatSearch::solve(Board& board, const RuleSet& rules, Mode mode,
+    const SearchDeadline* deadline, const std::atomic<bool>* stop, long long nodeLimit)
+{
+    ThreatResult res;
+    if (board.status() != GameStatus::Ongoing)
+        return res;
+    if (cacheKeys_.empty()) {
+        const std::size_t n = std::bit_floor(std::max<std::size_t>(cfg_.cacheEntries, 1));
+        cacheKeys_.assign(n, 0);
+        cacheDepth_.assign(n, 0);
+    }
+    rules_ = &rules;
+    mode_ = mode;
+    attacker_ = board.toPlay();
+    deadline_ = deadline;
+    stop_ = stop;
+    nodes_ = 0;
+    limit_ = nodeLimit > 0 ? std::min(nodeLimit, cfg_.nodeLimit) : cfg_.nodeLimit;
+    aborted_ = false;
+
+    // Approfondissement itératif : les gains courts d'abord, les échecs prouvés servent au suivant
+    const int maxDepth = mode == Mode::VCF ? cfg_.vcfDepth : cfg_.vctDepth;
+    std::vector<Move> line;
+    for (int depth = 1; depth <= maxDepth && !res.win; ++depth) {
+        line.clear();
+        const Outcome r = attack(board, depth, line);
+        res.win = r == Outcome::Win;
+        if (r == Outcome::Aborted)
+            break;
+    }
+    if (res.win)
+        res.line = std::move(line);
+    res.nodes = nodes_;
+    return res;
+}
+
+bool ThreatSearch::enterNode()
+{
+    if (aborted_)
+        return false;
+    if (++nodes_ >= limit_)
+        aborted_ = true;
+    else if ((nodes_ & 1023) == 0)
+        aborted_ = (stop_ && stop_->load(std::memory_order_relaxed))
+            || (deadline_ && deadline_->passed(std::chrono::steady_clock::now()));
+    return !aborted_;
+}
+
+uint64_t ThreatSearch::cacheKey(const Board& board) const noexcept
+{
+    return search::ttKey(board, *rules_) ^ (mode_ == Mode::VCT ? VCT_SALT : 0);
+}
+
+bool ThreatSearch::cachedFailure(uint64_t key, int depth) const noexcept
+{
+    const std::size_t i = key & (cacheKeys_.size() - 1);
+    return cacheKeys_[i] == key && cacheDepth_[i] >= depth;
+}
+
+void ThreatSearch::storeFailure(uint64_t key, int depth)
+{
+    const std::size_t i = key & (cacheKeys_.size() - 1);
+    cacheKeys_[i] = key;
+    cacheDepth_[i] = static_cast<int8_t>(std::min(depth, 127));
+}
+
+std::vector<ThreatSearch::Threat> ThreatSearch::threats(const Board& board) const
+{
+    const BoardState& st = board.rawState();
+    const Cell me = playerToCell(attacker_);
+    const uint8_t mask = shapes::FOUR | shapes::OPEN_FOUR | (mode_ == Mode::VCT ? shapes::OPEN_THREE : 0);
+    std::array<uint8_t, BoardState::N> fours {}, threes {};
+    Bitboard cells, openFours;
+    forEachShape(st, me, mask, [&](uint16_t i, int, uint8_t f) {
+        cells.set(i);
+        if (f & (shapes::FOUR | shapes::OPEN_FOUR))
+            ++fours[i];
+        else
+            ++threes[i];
+        if (f & shapes::OPEN_FOUR)
+            openFours.set(i);
+    });
+    std::vector<Threat> out;
+    cells.forEach([&](uint16_t i) {
+        if (fours[i] == 0 && mode_ == Mode::VCF)
+            return;
+        // Quatre ouvert, puis quatre-quatre / quatre-trois, puis quatre simple, puis trois
+        out.push_back({ Move { Pos::fromIndex(i), attacker_ }, (openFours.test(i) ? 16 : 0) + 4 * fours[i] + 2 * threes[i] });
+    });
+    std::stable_sort(out.begin(), out.end(), [](const Threat& a, const Threat& b) { return a.priority > b.priority; });
+    return out;
+}
+
+ThreatSearch::Outcome ThreatSearch::attack(Board& board, int depth, std::vector<Move>& line)
+{
+    if (!enterNode())
+        return Outcome::Aborted;
+    const BoardState& st = board.rawState();
+    const Cell me = playerToCell(attacker_);
+    const Cell opp = playerToCell(opponent(attacker_));
+
+    // 1) Gain immédiat : cinq qui tient ou capture de la dernière paire (vérifiés en jouant)
+    Bitboard wins = shapeCells(st, me, shapes::FIVE);
+    if (rules_->capturesEnabled)
+        captureCells(board, me).forEach([&](uint16_t i) {
+            capture::CaptureBuffer removed;
+            if (st.pairs(me) + capture::findCaptures(st, Move { Pos::fromIndex(i), attacker_ }, removed) >= rules_->captureWinPairs)
+                wins.set(i);
+        });
+    bool won = false;
+    wins.forEach([&](uint16_t i) {
+        const Move m { Pos::fromIndex(i), attacker_ };
+        if (won || !board.makeMove(m, *rules_))
+            return;
+        const GameStatus s = board.status();
+        board.unmakeMove();
+        if (s == GameStatus::WinByAlign || s == GameStatus::WinByCapture) {
+            line.push_back(m);
+            won = true;
+        }
+    });
+    if (won)
+        return Outcome::Win;
+    if (depth <= 0)
+        return Outcome::NoWin;
+
+    const uint64_t key = cacheKey(board);
+    if (cachedFailure(key, depth))
+        return Outcome::NoWin;
+
+    // 2) Cinq adverse à casser : hors de l'espace des menaces. Quatre adverse : seule une
+    //    menace posée sur sa case de gain garde l'initiative.
+    if (st.hasFive(opp)) {
+        storeFailure(key, depth);
+        return Outcome::NoWin;
+    }
+    const Bitboard mustBlock = shapeCells(st, opp, shapes::FIVE);
+
+    const std::size_t base = line.size();
+    for (const Threat& t : threats(board)) {
+        if (mustBlock.any() && !mustBlock.test(BoardState::idx(t.move.pos)))
+            continue;
+        if (!board.makeMove(t.move, *rules_))
+            continue;
+        if (board.status() != GameStatus::Ongoing) { // nul : plateau plein
+            board.unmakeMove();
+            continue;
+        }
+        line.push_back(t.move);
+        const Outcome r = defend(board, depth - 1, line);
+        board.unmakeMove();
+        if (r == Outcome::Win)
+            return r;
+        line.resize(base);
+        if (r == Outcome::Aborted)
+            return r;
+    }
+    storeFailure(key, depth);
+    return Outcome::NoWin;
+}
+
+ThreatSearch::Outcome ThreatSearch::defend(Board& board, int depth, std::vector<Move>& line)
+{
+    if (!enterNode())
+        return Outcome::Aborted;
+    const BoardState& st = board.rawState();
+    const Player def = opponent(attacker_);
+    const Cell me = playerToCell(attacker_);
+    const Cell opp = playerToCell(def);
+    const Pos threat = line.back().pos;
+
+    // Parades : tout coup hors de cet ensemble laisse l'attaquant conclure
+    Bitboard replies;
+    const Bitboard fives = shapeCells(st, me, shapes::FIVE);
+    if (fives.any()) {
+        // Quatre : chaque cinq qui tient est à bloquer, ou à rendre cassable par un flanc
+        bool stands = false;
+        fives.forEach([&](uint16_t i) {
+            Bitboard flanks;
+            if (fiveStands(st, Pos::fromIndex(i), attacker_, *rules_, flanks)) {
+                stands = true;
+                replies |= flanks;
+            }
+        });
+        if (!stands)
+            return Outcome::NoWin; // aucun cinq ne tiendrait : pas une menace
+        replies |= fives;
+    } else {
+        if (mode_ != Mode::VCT)
+            return Outcome::NoWin;
+        // Trois : menace seulement si, le défenseur passant, l'attaquant gagne par quatres.
+        // Parades : les lignes des coups de ce gain et les flancs de leurs paires.
+        std::vector<Move> followUp;
+        board.forceSide(attacker_);
+        mode_ = Mode::VCF;
+        const Outcome r = attack(board, PASS_DEPTH, followUp);
+        mode_ = Mode::VCT;
+        board.forceSide(def);
+        if (r != Outcome::Win)
+            return r;
+        addVicinity(st, threat, me, replies);
+        for (const Move& m : followUp)
+            if (m.by == attacker_)
+                addVicinity(st, m.pos, me, replies);
+        replies |= shapeCells(st, opp, shapes::FOUR | shapes::OPEN_FOUR);
+    }
+    replies |= shapeCells(st, opp, shapes::FIVE);
+    if (rules_->capturesEnabled) {
+        replies |= captureCells(board, opp);
+        // Une capture de plus gagne : toute menace de capture casse aussi le cinq
+        if (st.pairs(opp) + 1 >= rules_->captureWinPairs)
+            replies |= captureThreatCells(board, opp);
+    }
+    replies.andNot(st.occupancy());
+
+    // Toutes les parades doivent perdre ; la ligne retenue suit la plus longue résistance
+    const std::size_t base = line.size();
+    std::vector<Move> longest;
+    Outcome result = Outcome::Win;
+    replies.forEach([&](uint16_t i) {
+        const Move m { Pos::fromIndex(i), def };
+        if (result != Outcome::Win || !board.makeMove(m, *rules_))
+            return;
+        if (board.status() != GameStatus::Ongoing) { // le défenseur gagne (ou nul)
+            board.unmakeMove();
+            result = Outcome::NoWin;
+            return;
+        }
+        line.push_back(m);
+        const Outcome r = attack(board, depth, line);
+        board.unmakeMove();
+        if (r != Outcome::Win)
+            result = r;
+        else if (line.size() - base > longest.size())
+            longest.assign(line.begin() + static_cast<std::ptrdiff_t>(base), line.end());
+        line.resize(base);
+    });
+    if (result == Outcome::Win)
+        line.insert(line.end(), longest.begin(), longest.end());
+    return result;
+}
+
+} // namespace gomoku
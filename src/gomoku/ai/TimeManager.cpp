@@ -0,0 +1,71 @@
+// TimeManager.cpp - Soft/hard time limits of a search
+#include "gomoku/ai/TimeManager.hpp"
+#include "gomoku/ai/SearchHelpers.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+namespace {
+    constexpr int CLOCK_SAFETY_MS = 30; // left on the clock for unwinding and move transmission
+    constexpr int DEFAULT_MOVES_TO_GO = 30; // moves still to play when the control does not say
+    constexpr int STABLE_SCORE_MARGIN = 500; // below closedThree: same assessment of the position
+    constexpr int DROP_SCALE = 3000; // an openThree worth of score lost doubles the time
+    constexpr double DOMINANT_NODE_SHARE = 0.9; // alternatives refuted cheaply
+} // namespace
+
+TimeManager::Limits TimeManager::allocate(int timeBudgetMs, const GameClock& gameClock, int softPercent) noexcept
+{
+    Limits l;
+    const int percent = std::clamp(softPercent, 1, 100);
+    if (gameClock.remainingMs <= 0) {
+        l.hardMs = std::max(1, timeBudgetMs);
+        l.optimumMs = std::max(1, l.hardMs * percent / 100);
+        return l;
+    }
+    // Clock: a fair share of the remaining time plus most of this move's increment.
+    // Hard limit: a few shares, never more than half of what is left (all of it on the last move).
+    const int usable = std::max(1, gameClock.remainingMs - CLOCK_SAFETY_MS);
+    const int movesToGo = gameClock.movesToGo > 0 ? gameClock.movesToGo : DEFAULT_MOVES_TO_GO;
+    const int share = std::min(usable, usable / movesToGo + gameClock.incrementMs * 3 / 4);
+    l.optimumMs = std::max(1, share);
+    l.hardMs = std::max(l.optimumMs, std::min(std::max(usable / 2, share), share * 4));
+    return l;
+}
+
+bool TimeManager::iterationDone(const Move& best, int score, double bestNodeShare, clock::time_point now) noexcept
+{
+    const bool first = iterations_ == 0;
+    const bool flipped = !first && best != lastBest_;
+    const int drop = first ? 0 : lastScore_ - score;
+    if (!first && !flipped && std::abs(score - lastScore_) < STABLE_SCORE_MARGIN)
+        ++stableIterations_;
+    else
+        stableIterations_ = 0;
+    instability_ = instability_ * 0.5 + (flipped ? 1.0 : 0.0);
+    lastBest_ = best;
+    lastScore_ = score;
+    ++iterations_;
+
+    // A forced win is found: deeper iterations cannot change the decision
+    if (score >= search::MATE_SCORE - 1000)
+        return true;
+
+    double s = 1.0 + instability_;
+    if (stableIterations_ >= 3)
+        s *= 0.5;
+    else if (stableIterations_ == 2)
+        s *= 0.75;
+    if (drop > STABLE_SCORE_MARGIN)
+        s *= 1.0 + static_cast<double>(std::min(drop, DROP_SCALE)) / DROP_SCALE;
+    if (bestNodeShare >= DOMINANT_NODE_SHARE)
+        s *= 0.6;
+    scale_ = s;
+
+    const Limits l = limits();
+    const auto windowStart = deadline_.get() - std::chrono::milliseconds(l.hardMs);
+    const double elapsedMs = std::chrono::duration<double, std::milli>(now - windowStart).count();
+    return elapsedMs >= l.optimumMs * s;
+}
+
+} // namespace gomoku
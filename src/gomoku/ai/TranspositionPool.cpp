@@ -0,0 +1,54 @@
+// TranspositionPool.cpp - Process-wide shared transposition table
+#include "gomoku/ai/TranspositionPool.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace gomoku::inline GOMOKU_SIZE_NS::ttpool {
+
+namespace {
+    std::mutex poolMutex;
+    std::size_t budget = DEFAULT_BUDGET_BYTES;
+    std::weak_ptr<TranspositionTable> shared;
+
+    // resizeBytes rounds up; a budget must round down
+    std::size_t floorPow2(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p <= n / 2)
+            p <<= 1;
+        return p;
+    }
+} // namespace
+
+void setBudgetBytes(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    budget = bytes ? std::max(bytes, TranspositionTable::MIN_BYTES) : DEFAULT_BUDGET_BYTES;
+}
+
+std::size_t budgetBytes()
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return budget;
+}
+
+std::shared_ptr<TranspositionTable> acquire()
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (auto tt = shared.lock())
+        return tt;
+    auto tt = std::make_shared<TranspositionTable>();
+    tt->resizeBytes(floorPow2(budget));
+    tt->prefault(); // table of every session: filled anyway, faulted once outside any search
+    shared = tt;
+    return tt;
+}
+
+std::size_t liveBytes()
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    const auto tt = shared.lock();
+    return tt ? tt->bytes() : 0;
+}
+
+} // namespace gomoku::ttpool
@@ -0,0 +1,275 @@
+// TranspositionTable.cpp - Backing memory of the transposition table
+#include "gomoku/ai/TranspositionTable.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GOMOKU_TT_MMAP 1
+#endif
+
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+#ifdef GOMOKU_TT_MMAP
+constexpr std::size_t HUGE_PAGE = 2ull << 20;
+
+// Probes land on random buckets: with 4 KB pages nearly every one is also a TLB miss.
+// Try explicit 2 MB pages (needs a reserved hugetlb pool): reserved memory, faulted in at
+// once. Else a normal mapping, whose transparent huge pages are only requested by
+// prefault(): faulted lazily, each one would zero (and may compact) 2 MB inside a search.
+static void* mapTable(std::size_t size, bool& huge)
+{
+    huge = false;
+#ifdef MAP_HUGETLB
+    if (size % HUGE_PAGE == 0) {
+        void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            huge = true;
+            return mem;
+        }
+    }
+#endif
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return mem == MAP_FAILED ? nullptr : mem;
+}
+#endif
+
+namespace {
+    constexpr char FILE_MAGIC[8] = { 'G', 'M', 'K', 'T', 'T', 'A', 'B', '\0' };
+    constexpr uint32_t FILE_VERSION = 1;
+    constexpr std::size_t FILE_HEADER_BYTES = 4096; // keeps the mapped bucket array page-aligned
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t boardSize;
+        uint64_t fingerprint;
+        uint64_t buckets;
+        uint64_t bucketBytes;
+    };
+    static_assert(sizeof(FileHeader) <= FILE_HEADER_BYTES);
+
+    bool headerMatches(const FileHeader& h, uint64_t fingerprint, std::size_t bucketBytes, std::size_t fileBytes)
+    {
+        return std::memcmp(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 && h.version == FILE_VERSION
+            && h.boardSize == static_cast<uint32_t>(BOARD_SIZE) && h.fingerprint == fingerprint
+            && h.bucketBytes == bucketBytes && h.buckets >= TranspositionTable::SCRUB_PERIOD && (h.buckets & (h.buckets - 1)) == 0
+            && fileBytes == FILE_HEADER_BYTES + h.buckets * bucketBytes;
+    }
+} // namespace
+
+TranspositionTable::~TranspositionTable() { release(); }
+
+void TranspositionTable::resizeBytes(std::size_t bytes)
+{
+    if (!bytes)
+        bytes = (16ull << 20);
+    static_assert(MIN_BYTES == MIN_BUCKETS * sizeof(Bucket));
+    std::size_t n = bytes / sizeof(Bucket);
+    if (n < MIN_BUCKETS)
+        n = MIN_BUCKETS;
+    std::size_t pow2 = 1;
+    while (pow2 < n)
+        pow2 <<= 1;
+
+    if (table && pow2 == mask + 1) {
+        clear();
+        return;
+    }
+    release();
+
+    // Anonymous zero pages: a zero slot has no USED bit, so fresh memory reads as an empty
+    // table. 4 KB pages fault in as buckets are touched (see prefault()); only hugetlb
+    // pages, already reserved, are faulted in here.
+    const std::size_t size = pow2 * sizeof(Bucket);
+#ifdef GOMOKU_TT_MMAP
+    table = static_cast<Bucket*>(mapTable(size, hugePages_));
+#else
+    table = static_cast<Bucket*>(::operator new(size, std::align_val_t { alignof(Bucket) }, std::nothrow));
+    if (table)
+        std::memset(static_cast<void*>(table), 0, size);
+    faultedIn_ = table != nullptr;
+#endif
+    mask = table ? pow2 - 1 : 0;
+    generation.store(0, std::memory_order_relaxed);
+    firstGen.store(0, std::memory_order_relaxed);
+    if (hugePages_)
+        prefault();
+}
+
+void TranspositionTable::prefault() noexcept
+{
+    if (!table || faultedIn_ || fileMap_)
+        return;
+#if defined(GOMOKU_TT_MMAP) && defined(MADV_HUGEPAGE)
+    if (!hugePages_ && bytes() >= HUGE_PAGE)
+        hugePages_ = madvise(table, bytes(), MADV_HUGEPAGE) == 0;
+#endif
+    // One write per 4 KB page; fetch_or(0) keeps whatever a slot already holds
+    for (std::size_t b = 0; b <= mask; b += 4096 / sizeof(Bucket))
+        std::atomic_ref<uint64_t>(table[b].slots[0].check).fetch_or(0, std::memory_order_relaxed);
+    faultedIn_ = true;
+}
+
+void TranspositionTable::newSearch() noexcept
+{
+    const auto g = static_cast<uint8_t>(generation.fetch_add(1, std::memory_order_relaxed) + 1);
+    // Concurrent callers (sessions sharing the table) may bump generation more than once
+    // between this load and the CAS: move firstGen up to g - LIVE_SPAN + 1 whatever the gap.
+    // A gap of LIVE_SPAN + SCRUB_PERIOD or more means firstGen is already ahead of this g
+    // (clear() or a later caller won the race): never move it back.
+    uint8_t first = firstGen.load(std::memory_order_relaxed);
+    for (;;) {
+        const auto gap = static_cast<uint8_t>(g - first);
+        if (gap < LIVE_SPAN || gap >= LIVE_SPAN + SCRUB_PERIOD)
+            break;
+        if (firstGen.compare_exchange_weak(first, static_cast<uint8_t>(g - LIVE_SPAN + 1), std::memory_order_relaxed))
+            break;
+    }
+    if (!table)
+        return;
+
+    // Slice g % SCRUB_PERIOD: an entry dies at most LIVE_SPAN generations after its store and
+    // is zeroed within SCRUB_PERIOD more. A concurrent store racing the scrub is at worst lost.
+    const std::size_t slice = (mask + 1) / SCRUB_PERIOD;
+    Bucket* const end = table + slice * (g % SCRUB_PERIOD + 1);
+    for (Bucket* b = end - slice; b != end; ++b) {
+        for (Slot& s : b->slots) {
+            const uint64_t data = load(s.data);
+            if ((data & USED) && !live(data)) {
+                std::atomic_ref<uint64_t>(s.data).store(0, std::memory_order_relaxed);
+                std::atomic_ref<uint64_t>(s.check).store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+bool TranspositionTable::saveFile(const std::string& path, uint64_t fingerprint) const
+{
+    if (!table)
+        return false;
+    // Written aside then renamed: a process mapping the previous file keeps valid pages
+    const std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+
+    FileHeader h {};
+    std::memcpy(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    h.version = FILE_VERSION;
+    h.boardSize = static_cast<uint32_t>(BOARD_SIZE);
+    h.fingerprint = fingerprint;
+    h.buckets = mask + 1;
+    h.bucketBytes = sizeof(Bucket);
+    std::array<char, FILE_HEADER_BYTES> head {};
+    std::memcpy(head.data(), &h, sizeof(h));
+    out.write(head.data(), static_cast<std::streamsize>(head.size()));
+
+    // Live entries are rewritten as generation 0 (live again after loading); dead ones as empty
+    std::vector<Bucket> chunk(4096);
+    for (std::size_t first = 0; first <= mask && out; first += chunk.size()) {
+        const std::size_t n = std::min(chunk.size(), mask + 1 - first);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (int k = 0; k < BUCKET_SIZE; ++k) {
+                Slot& src = table[first + i].slots[k];
+                Slot& dst = chunk[i].slots[k];
+                const uint64_t data = load(src.data);
+                if (!live(data)) {
+                    dst = Slot {};
+                    continue;
+                }
+                const uint64_t key = load(src.check) ^ data;
+                dst.data = data & ~GEN_BITS;
+                dst.check = key ^ dst.data;
+            }
+        }
+        out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(n * sizeof(Bucket)));
+    }
+    out.close();
+    if (!out || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TranspositionTable::loadFile(const std::string& path, uint64_t fingerprint)
+{
+    FileHeader h {};
+#ifdef GOMOKU_TT_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st {};
+    std::size_t size = 0;
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= FILE_HEADER_BYTES) {
+        size = static_cast<std::size_t>(st.st_size);
+        mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (mem == MAP_FAILED)
+        return false;
+    std::memcpy(&h, mem, sizeof(h));
+    if (!headerMatches(h, fingerprint, sizeof(Bucket), size)) {
+        munmap(mem, size);
+        return false;
+    }
+    release();
+    fileMap_ = mem;
+    fileMapBytes_ = size;
+    table = reinterpret_cast<Bucket*>(static_cast<char*>(mem) + FILE_HEADER_BYTES);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    const auto size = static_cast<std::size_t>(in.tellg());
+    in.seekg(0);
+    if (size < FILE_HEADER_BYTES || !in.read(reinterpret_cast<char*>(&h), sizeof(h))
+        || !headerMatches(h, fingerprint, sizeof(Bucket), size))
+        return false;
+    auto* mem = static_cast<Bucket*>(::operator new(size - FILE_HEADER_BYTES, std::align_val_t { alignof(Bucket) }, std::nothrow));
+    in.seekg(static_cast<std::streamoff>(FILE_HEADER_BYTES));
+    if (!mem || !in.read(reinterpret_cast<char*>(mem), static_cast<std::streamsize>(size - FILE_HEADER_BYTES))) {
+        ::operator delete(mem, std::align_val_t { alignof(Bucket) });
+        return false;
+    }
+    release();
+    table = mem;
+    faultedIn_ = true;
+#endif
+    mask = static_cast<std::size_t>(h.buckets - 1);
+    generation.store(0, std::memory_order_relaxed);
+    firstGen.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void TranspositionTable::release() noexcept
+{
+    if (!table)
+        return;
+#ifdef GOMOKU_TT_MMAP
+    if (fileMap_)
+        munmap(fileMap_, fileMapBytes_);
+    else
+        munmap(table, (mask + 1) * sizeof(Bucket));
+    fileMap_ = nullptr;
+    fileMapBytes_ = 0;
+#else
+    ::operator delete(table, std::align_val_t { alignof(Bucket) });
+#endif
+    table = nullptr;
+    mask = 0;
+    hugePages_ = false;
+    faultedIn_ = false;
+}
+
+} // namespace gomoku
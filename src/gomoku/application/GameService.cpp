@@ -3,7 +3,7 @@
 #include <algorithm>
 #include <stdexcept>
 
-namespace gomoku::application {
+namespace gomoku::inline GOMOKU_SIZE_NS::application {
 
 GameService::GameService(std::unique_ptr<ISearchEngine> searchEngine)
     : board_(std::make_unique<Board>())
@@ -15,6 +15,7 @@ GameService::~GameService() = default;
 
 void GameService::startNewGame(const RuleSet& rules)
 {
+    stopPondering();
     rules_ = rules;
     board_->reset();
     moveHistory_.clear();
@@ -22,6 +23,7 @@ void GameService::startNewGame(const RuleSet& rules)
 
 void GameService::reset()
 {
+    stopPondering();
     board_->reset();
     moveHistory_.clear();
 }
@@ -64,6 +66,10 @@ PlayResult GameService::makeMove(const Move& move)
     auto result = board_->tryPlay(move, rules_);
     if (result.success) {
         moveHistory_.push_back(move);
+        if (ponderMove_ && !ponderHit_ && move == *ponderMove_)
+            ponderHit_ = true;
+        else
+            stopPondering();
     }
 
     return result;
@@ -80,6 +86,7 @@ bool GameService::undo()
         return false;
     }
 
+    stopPondering();
     bool success = board_->undo();
     if (success && !moveHistory_.empty()) {
         moveHistory_.pop_back();
@@ -98,6 +105,7 @@ bool GameService::redo()
         return false;
     }
 
+    stopPondering();
     bool success = board_->redo(rules_);
     if (success) {
         auto m = board_->lastMove();
@@ -115,6 +123,7 @@ std::vector<uint8_t> GameService::saveGame() const
 
 bool GameService::loadGame(const std::vector<uint8_t>& data)
 {
+    stopPondering();
     // Load board state
     if (!board_->load(data, rules_)) {
         return false;
@@ -175,7 +184,13 @@ std::optional<Move> GameService::getAIMove(int timeMs, SearchStats* outStats)
     }
 
     SearchStats stats;
-    auto move = searchEngine_->suggestMove(*board_, rules_, timeMs, &stats);
+    std::optional<Move> move;
+    if (ponderHit_)
+        move = searchEngine_->ponderHit(timeMs, &stats);
+    ponderMove_.reset();
+    ponderHit_ = false;
+    if (!move)
+        move = searchEngine_->suggestMove(*board_, rules_, timeMs, &stats); // stops a ponder still running
 
     if (outStats)
         *outStats = stats;
@@ -185,9 +200,41 @@ std::optional<Move> GameService::getAIMove(int timeMs, SearchStats* outStats)
 
 void GameService::setSearchEngine(std::unique_ptr<ISearchEngine> engine)
 {
+    stopPondering();
     searchEngine_ = std::move(engine);
 }
 
+void GameService::setGameClock(const GameClock& clock)
+{
+    if (searchEngine_)
+        searchEngine_->setGameClock(clock);
+}
+
+bool GameService::startPondering(const std::vector<Move>& pv)
+{
+    stopPondering();
+    // pv[0] must be the move just played, otherwise pv[1] is not a reply to this position
+    const auto last = board_->lastMove();
+    if (!searchEngine_ || pv.size() < 2 || !last || pv[0] != *last || board_->status() != GameStatus::Ongoing)
+        return false;
+    Board expected = *board_;
+    if (!expected.tryPlay(pv[1], rules_).success || expected.status() != GameStatus::Ongoing)
+        return false;
+    searchEngine_->startPondering(expected, rules_);
+    ponderMove_ = pv[1];
+    return true;
+}
+
+void GameService::stopPondering()
+{
+    if (!ponderMove_)
+        return;
+    if (searchEngine_)
+        searchEngine_->stopPondering();
+    ponderMove_.reset();
+    ponderHit_ = false;
+}
+
 bool GameService::validateMove(const Move& move, std::string* reason) const
 {
     auto base = moveValidator_.validate(*board_, rules_, move);
@@ -1,7 +1,7 @@
 #include "gomoku/application/MoveValidator.hpp"
 #include "gomoku/core/Types.hpp"
 
-namespace gomoku::application {
+namespace gomoku::inline GOMOKU_SIZE_NS::application {
 
 MoveValidator::Result MoveValidator::validate(const IBoardView& board, const RuleSet& /*rules*/, const Move& move) const
 {
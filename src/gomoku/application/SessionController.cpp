@@ -1,12 +1,21 @@
 #include "gomoku/application/SessionController.hpp"
 #include "gomoku/ai/MinimaxSearchEngine.hpp"
+#include <algorithm>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
+
+// Sessions search into the process-wide TT: memory stays at the pool budget however many games run
+static SearchConfig sessionSearchConfig()
+{
+    SearchConfig cfg;
+    cfg.sharedTT = true;
+    return cfg;
+}
 
 SessionController::SessionController(const RuleSet& rules, Controller black, Controller white)
     : rules_(rules)
     , gameService_(std::make_unique<application::GameService>(
-          std::make_unique<ai::MinimaxSearchEngine>()))
+          std::make_unique<ai::MinimaxSearchEngine>(sessionSearchConfig())))
     , black_(black)
     , white_(white)
 {
@@ -42,6 +51,34 @@ Controller SessionController::controller(Player side) const
     return (side == Player::Black) ? black_ : white_;
 }
 
+void SessionController::setPondering(bool enabled)
+{
+    pondering_ = enabled;
+    if (!enabled)
+        gameService_->stopPondering();
+}
+
+void SessionController::setTimeControl(int mainMs, int incrementMs)
+{
+    mainMs_ = mainMs > 0 ? mainMs : 0;
+    incrementMs_ = mainMs_ > 0 ? std::max(0, incrementMs) : 0;
+    clocks_.fill(GameClock { mainMs_, incrementMs_, 0 });
+    gameService_->setGameClock(GameClock {});
+    turnStart_ = std::chrono::steady_clock::now();
+}
+
+void SessionController::chargeClock(Player mover)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (mainMs_ > 0) {
+        GameClock& c = clocks_[mover == Player::Black ? 0 : 1];
+        const auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(now - turnStart_).count();
+        // Pas de perte au temps : un drapeau tombé garde 1 ms pour rester une pendule
+        c.remainingMs = static_cast<int>(std::max<long long>(1, c.remainingMs - spent + c.incrementMs));
+    }
+    turnStart_ = now;
+}
+
 GamePlayResult SessionController::playHuman(Pos p)
 {
     Move m { p, gameService_->getCurrentPlayer() };
@@ -51,6 +88,7 @@ GamePlayResult SessionController::playHuman(Pos p)
     auto res = gameService_->makeMove(m);
     if (!res.success)
         return { false, res.error, std::nullopt, std::nullopt };
+    chargeClock(m.by);
     last_ = p;
     return { true, {}, m, std::nullopt };
 }
@@ -58,13 +96,18 @@ GamePlayResult SessionController::playHuman(Pos p)
 GamePlayResult SessionController::playAI(int timeMs)
 {
     SearchStats st {};
+    if (mainMs_ > 0)
+        gameService_->setGameClock(clock(gameService_->getCurrentPlayer()));
     auto bm = gameService_->getAIMove(timeMs, &st);
     if (!bm)
         return { false, "No AI move", std::nullopt, st };
     auto res = gameService_->makeMove(*bm);
     if (!res.success)
         return { false, res.error, std::nullopt, st };
+    chargeClock(bm->by);
     last_ = bm->pos;
+    if (pondering_ && ctrl(gameService_->getCurrentPlayer()) == Controller::Human)
+        gameService_->startPondering(st.principalVariation);
     return { true, {}, bm, st };
 }
 
@@ -77,6 +120,7 @@ GamePlayResult SessionController::undo(int halfMoves)
         any = true;
     }
     if (any) {
+        turnStart_ = std::chrono::steady_clock::now();
         auto m = gameService_->getBoard().lastMove();
         if (m)
             last_ = m->pos;
@@ -96,6 +140,7 @@ GamePlayResult SessionController::redo(int halfMoves)
         any = true;
     }
     if (any) {
+        turnStart_ = std::chrono::steady_clock::now();
         auto m = gameService_->getBoard().lastMove();
         if (m)
             last_ = m->pos;
@@ -111,12 +156,14 @@ void SessionController::reset(Player start)
         // Hack: play a null move concept not available; defer future enhancement.
     }
     last_.reset();
+    setTimeControl(mainMs_, incrementMs_);
 }
 
 GamePlayResult SessionController::load(const std::vector<uint8_t>& data)
 {
     bool ok = gameService_->loadGame(data);
     if (ok) {
+        turnStart_ = std::chrono::steady_clock::now();
         auto m = gameService_->getBoard().lastMove();
         if (m)
             last_ = m->pos;
@@ -2,12 +2,15 @@
 #include "gomoku/core/BoardState.hpp"
 #include "gomoku/core/CaptureEngine.hpp"
 #include "gomoku/core/PatternAnalyzer.hpp"
+#include "gomoku/core/RayTables.hpp"
+#include "gomoku/core/RulePolicy.hpp"
 #include "gomoku/core/Zobrist.hpp"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <string>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 // ------------------------------------------------
 
@@ -19,16 +22,17 @@ Cell Board::at(uint8_t x, uint8_t y) const
 {
     if (!isInside(x, y))
         return Cell::Empty;
-    return state.cells[BoardState::idx(x, y)];
+    return state.getCell(x, y);
 }
 
 Player Board::toPlay() const { return currentPlayer; }
 CaptureCount Board::capturedPairs() const { return { state.blackPairs, state.whitePairs }; }
 GameStatus Board::status() const { return gameState; }
-uint64_t Board::zobristKey() const { return state.zobristHash; }
+// Le statut de partie est replié dans la clé : une position terminale ne partage pas son entrée TT
+uint64_t Board::zobristKey() const { return state.zobristHash ^ zobrist::status(gameState); }
 
 bool Board::isInside(uint8_t x, uint8_t y) const { return x < BOARD_SIZE && y < BOARD_SIZE; }
-bool Board::isEmpty(uint8_t x, uint8_t y) const { return isInside(x, y) && state.cells[BoardState::idx(x, y)] == Cell::Empty; }
+bool Board::isEmpty(uint8_t x, uint8_t y) const { return isInside(x, y) && state.isEmpty(x, y); }
 
 int Board::stoneCount(Player p) const { return (p == Player::Black) ? state.blackStones : state.whiteStones; }
 
@@ -54,6 +58,14 @@ std::vector<Move> Board::lastMoves(std::size_t k) const
     return out;
 }
 
+std::size_t Board::lastMoves(std::size_t k, Move* out) const noexcept
+{
+    const std::size_t n = std::min(k, moveHistory.size());
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = moveHistory[moveHistory.size() - 1 - i].move;
+    return n;
+}
+
 const std::vector<Pos>& Board::occupiedPositions() const { return state.occupied_; }
 
 void Board::reset()
@@ -62,57 +74,68 @@ void Board::reset()
     currentPlayer = Player::Black;
     gameState = GameStatus::Ongoing;
     moveHistory.clear();
+    moveHistory.reserve(N); // pile d'undo réservée : makeMove n'alloue pas en recherche
     redoHistory.clear();
     // Side encoded in state.reset(true)
 }
 
 // ------------------------------------------------
-PlayResult Board::applyCore(Move m, const RuleSet& rules, bool record, bool clearRedo)
+PlayErrorCode Board::applyCore(Move m, const RuleSet& rules, bool record, const char** reason)
 {
+    // Un seul aiguillage sur les règles, puis un noyau spécialisé sans test de RuleSet
+    return rules::withPolicy(rules, [&](auto policy) {
+        return applyKernel<decltype(policy)>(m, rules, record, reason);
+    });
+}
+
+template <class P>
+PlayErrorCode Board::applyKernel(Move m, const RuleSet& rules, bool record, const char** reason)
+{
+    auto fail = [reason](PlayErrorCode c, const char* why) noexcept {
+        if (reason)
+            *reason = why;
+        return c;
+    };
+
     if (gameState != GameStatus::Ongoing) {
-        return PlayResult::fail(PlayErrorCode::GameFinished, "Game already finished.");
+        return fail(PlayErrorCode::GameFinished, "Game already finished.");
     }
     if (m.by != currentPlayer) {
-        return PlayResult::fail(PlayErrorCode::NotPlayersTurn, "Not this player's turn.");
+        return fail(PlayErrorCode::NotPlayersTurn, "Not this player's turn.");
     }
     if (!isEmpty(m.pos.x, m.pos.y)) {
-        return PlayResult::fail(PlayErrorCode::Occupied, "Cell not empty.");
+        return fail(PlayErrorCode::Occupied, "Cell not empty.");
     }
 
     bool mustBreak = false;
-    if (rules.allowFiveOrMore && rules.capturesEnabled) {
+    if constexpr (P::fiveOrMore && P::captures) {
         Player justPlayed = opponent(currentPlayer);
         Cell meC = playerToCell(justPlayed);
-        if (pattern::hasAnyFive(state, meC) && pattern::isFiveBreakableNow(state, justPlayed, rules))
+        if (pattern::hasAnyFive(state, meC) && pattern::fiveBreakableByCapture(state, justPlayed, rules.captureWinPairs))
             mustBreak = true;
     }
 
     bool allowDoubleThreeThisMove = false;
-    if (mustBreak) {
+    if (P::captures && mustBreak) {
         if (!capture::wouldCapture(state, m)) {
-            return PlayResult::fail(PlayErrorCode::RuleViolation, "Must break opponent's five.");
+            return fail(PlayErrorCode::RuleViolation, "Must break opponent's five.");
         }
-        Board sim = *this;
-        sim.state.placeStone(m.pos, playerToCell(m.by));
-        std::vector<Pos> removedTmp;
-        int gainedTmp = capture::applyCapturesAround(sim.state, m.pos, playerToCell(m.by), rules, removedTmp);
-        if (gainedTmp) {
-            if (m.by == Player::Black)
-                sim.state.blackPairs += gainedTmp;
-            else
-                sim.state.whitePairs += gainedTmp;
-        }
-        int myPairsAfter = (m.by == Player::Black ? sim.state.blackPairs : sim.state.whitePairs);
-        Cell oppFiveColor = playerToCell(opponent(currentPlayer));
-        bool breaks = (myPairsAfter >= rules.captureWinPairs) || (!pattern::hasAnyFive(sim.state, oppFiveColor));
+        // Pas de copie du plateau : la pierre posée ne touche pas les lignes adverses,
+        // on retire virtuellement les pierres capturées
+        capture::CaptureBuffer removedTmp;
+        const int gainedTmp = capture::findCaptures(state, m, removedTmp);
+        const int myPairsAfter = (m.by == Player::Black ? state.blackPairs : state.whitePairs) + gainedTmp;
+        const Cell oppFiveColor = playerToCell(opponent(currentPlayer));
+        const bool breaks = (myPairsAfter >= rules.captureWinPairs)
+            || !pattern::hasFiveAfterRemoving(state, oppFiveColor, removedTmp.data(), 2 * gainedTmp);
         if (!breaks) {
-            return PlayResult::fail(PlayErrorCode::RuleViolation, "Must break opponent's five.");
+            return fail(PlayErrorCode::RuleViolation, "Must break opponent's five.");
         }
         allowDoubleThreeThisMove = true;
     }
 
-    if (!allowDoubleThreeThisMove && pattern::createsIllegalDoubleThree(state, m, rules)) {
-        return PlayResult::fail(PlayErrorCode::RuleViolation, "Illegal double-three.");
+    if (!allowDoubleThreeThisMove && pattern::createsIllegalDoubleThree<P>(state, m)) {
+        return fail(PlayErrorCode::RuleViolation, "Illegal double-three.");
     }
 
     // Préparation Undo (si record)
@@ -130,23 +153,24 @@ PlayResult Board::applyCore(Move m, const RuleSet& rules, bool record, bool clea
 
     state.placeStone(m.pos, playerToCell(m.by));
 
-    std::vector<Pos> capturedLocal; // utilisera u.capturedStones si record
-    auto& capVec = record ? u.capturedStones : capturedLocal;
-    int gained = capture::applyCapturesAround(state, m.pos, playerToCell(m.by), rules, capVec);
-    if (gained) {
-        if (m.by == Player::Black)
-            state.blackPairs += gained;
-        else
-            state.whitePairs += gained;
+    if constexpr (P::captures) {
+        const int gained = capture::applyCaptures(state, m.pos, playerToCell(m.by), u.capturedStones);
+        u.capturedCount = static_cast<uint8_t>(2 * gained);
+        if (gained)
+            state.addPairs(playerToCell(m.by), gained);
     }
 
-    if (rules.allowFiveOrMore && pattern::checkFiveOrMoreFrom(state, m.pos, playerToCell(m.by))) {
-        if (!pattern::isFiveBreakableNow(state, m.by, rules)) {
-            gameState = GameStatus::WinByAlign;
+    if constexpr (P::fiveOrMore) {
+        if (pattern::checkFiveOrMoreFrom(state, m.pos, playerToCell(m.by))) {
+            bool breakable = false;
+            if constexpr (P::captures)
+                breakable = pattern::fiveBreakableByCapture(state, m.by, rules.captureWinPairs);
+            if (!breakable)
+                gameState = GameStatus::WinByAlign;
         }
     }
 
-    if (rules.capturesEnabled && gameState == GameStatus::Ongoing) {
+    if (P::captures && gameState == GameStatus::Ongoing) {
         if (state.blackPairs >= rules.captureWinPairs || state.whitePairs >= rules.captureWinPairs)
             gameState = GameStatus::WinByCapture;
     }
@@ -154,21 +178,36 @@ PlayResult Board::applyCore(Move m, const RuleSet& rules, bool record, bool clea
     if (gameState == GameStatus::Ongoing && isBoardFull())
         gameState = GameStatus::Draw;
 
-    if (record) {
-        moveHistory.push_back(std::move(u));
-        if (clearRedo) {
-            redoHistory.clear();
-        }
-    }
+    if (record)
+        moveHistory.push_back(u);
     currentPlayer = opponent(currentPlayer);
     state.flipSide();
 
-    return PlayResult::ok();
+    return PlayErrorCode::None;
+}
+
+static PlayResult toPlayResult(PlayErrorCode code, const char* reason)
+{
+    return code == PlayErrorCode::None ? PlayResult::ok() : PlayResult::fail(code, reason);
 }
 
 PlayResult Board::tryPlay(Move m, const RuleSet& rules)
 {
-    return applyCore(m, rules, true, true);
+    const char* reason = "";
+    const PlayErrorCode code = applyCore(m, rules, true, &reason);
+    if (code == PlayErrorCode::None)
+        redoHistory.clear();
+    return toPlayResult(code, reason);
+}
+
+bool Board::makeMove(Move m, const RuleSet& rules)
+{
+    return applyCore(m, rules, true) == PlayErrorCode::None;
+}
+
+void Board::unmakeMove() noexcept
+{
+    revertLast();
 }
 
 bool Board::speculativeTry(Move m, const RuleSet& rules, PlayResult* out)
@@ -190,36 +229,24 @@ bool Board::speculativeTry(Move m, const RuleSet& rules, PlayResult* out)
         Pos p;
         Cell before;
     };
-    // Générer les positions candidates pouvant être capturées (x1,x2) pour chaque direction ±
-    static constexpr int DX[4] = { 1, 0, 1, 1 };
-    static constexpr int DY[4] = { 0, 1, 1, -1 };
-    CellSnapshot candidates[16];
+    // Positions pouvant être capturées (±1, ±2 dans chaque direction) : toutes distinctes,
+    // lues dans la table de voisinage (aucun test de bord)
+    CellSnapshot candidates[capture::MAX_CAPTURED_STONES];
     int candCount = 0;
-    bool seen[BOARD_SIZE * BOARD_SIZE] = { false };
-    auto mark = [&](int x, int y) {
-        if (!isInside(static_cast<uint8_t>(x), static_cast<uint8_t>(y)))
-            return;
-        int idFlat = y * BOARD_SIZE + x;
-        if (seen[idFlat])
-            return;
-        seen[idFlat] = true;
-        candidates[candCount++] = CellSnapshot { Pos { (uint8_t)x, (uint8_t)y }, at(static_cast<uint8_t>(x), static_cast<uint8_t>(y)) };
-    };
+    const uint16_t i0 = BoardState::idx(m.pos);
     for (int d = 0; d < 4; ++d) {
-        int x1 = m.pos.x + DX[d], y1 = m.pos.y + DY[d];
-        int x2 = m.pos.x + 2 * DX[d], y2 = m.pos.y + 2 * DY[d];
-        mark(x1, y1);
-        mark(x2, y2);
-        int X1 = m.pos.x - DX[d], Y1 = m.pos.y - DY[d];
-        int X2 = m.pos.x - 2 * DX[d], Y2 = m.pos.y - 2 * DY[d];
-        mark(X1, Y1);
-        mark(X2, Y2);
+        const auto& nb = rays::lineNbrByDir[d][i0];
+        for (int k = 0; k < std::min<int>(2, nb.fwdLen); ++k)
+            candidates[candCount++] = CellSnapshot { Pos::fromIndex(nb.fwd[k]), state.getCell(Pos::fromIndex(nb.fwd[k])) };
+        for (int k = 0; k < std::min<int>(2, nb.bwdLen); ++k)
+            candidates[candCount++] = CellSnapshot { Pos::fromIndex(nb.bwd[k]), state.getCell(Pos::fromIndex(nb.bwd[k])) };
     }
 
-    PlayResult pr = applyCore(m, rules, false);
+    const char* reason = "";
+    const PlayErrorCode code = applyCore(m, rules, false, &reason);
     if (out)
-        *out = pr;
-    if (!pr.success) {
+        *out = toPlayResult(code, reason);
+    if (code != PlayErrorCode::None) {
         // Aucune mutation durable si échec (toutes les validations échouantes précèdent la pose).
         return false;
     }
@@ -256,11 +283,16 @@ bool Board::undo()
 {
     if (moveHistory.empty())
         return false;
-    UndoEntry u = std::move(moveHistory.back());
-    moveHistory.pop_back();
 
     // Sauvegarder le coup annulé dans l'historique de redo
-    redoHistory.push_back(u.move);
+    redoHistory.push_back(moveHistory.back().move);
+    revertLast();
+    return true;
+}
+
+void Board::revertLast() noexcept
+{
+    const UndoEntry& u = moveHistory.back();
 
     // Restaurer le joueur courant
     currentPlayer = u.playerBefore;
@@ -270,8 +302,8 @@ bool Board::undo()
 
     // Restaurer les pierres capturées
     Cell oppC = (u.move.by == Player::Black ? Cell::White : Cell::Black);
-    for (auto rp : u.capturedStones) {
-        state.placeStone(rp, oppC);
+    for (int i = 0; i < u.capturedCount; ++i) {
+        state.placeStone(u.capturedStones[i], oppC);
     }
 
     // Restaurer les compteurs
@@ -284,7 +316,7 @@ bool Board::undo()
     // Restaurer le hash Zobrist sauvegardé (plus fiable que de le reconstruire)
     state.zobristHash = u.zobristBefore;
 
-    return true;
+    moveHistory.pop_back();
 }
 
 bool Board::canRedo() const
@@ -306,10 +338,8 @@ bool Board::redo(const RuleSet& rules)
     redoHistory.pop_back();
 
     // applyCore va l'ajouter à moveHistory.
-    // Important : clearRedo = false pour ne pas effacer le reste de la pile redo.
-    PlayResult pr = applyCore(m, rules, true, false);
-
-    if (!pr.success) {
+    // Important : contrairement à tryPlay, on n'efface pas le reste de la pile redo.
+    if (applyCore(m, rules, true) != PlayErrorCode::None) {
         // Si par miracle le coup n'est plus valide (ex: changement de règles entre temps ?),
         // on le remet pour ne pas le perdre, ou on considère que la chaîne est rompue.
         // Ici on le remet pour être safe.
@@ -401,11 +431,9 @@ bool Board::load(const std::vector<uint8_t>& data, const RuleSet& rules)
             return false; // Truncated data
 
         // Replay move
-        // Note: applyCore clears redoHistory if clearRedo=true.
-        // We want to keep redoHistory empty until we finish loading moves,
-        // then we load redoHistory. So clearRedo=true is fine (and safer).
-        PlayResult pr = applyCore(*mOpt, rules, true, true);
-        if (!pr.success) {
+        // redoHistory stays empty until we finish loading moves,
+        // then we load redoHistory.
+        if (applyCore(*mOpt, rules, true) != PlayErrorCode::None) {
             // If a move in history is invalid under current rules, load fails
             reset();
             return false;
@@ -431,6 +459,12 @@ bool Board::load(const std::vector<uint8_t>& data, const RuleSet& rules)
 
 // ------------------------------------------------
 std::vector<Move> Board::legalMoves(Player p, const RuleSet& rules) const
+{
+    return rules::withPolicy(rules, [&](auto policy) { return legalMovesFor<decltype(policy)>(p); });
+}
+
+template <class P>
+std::vector<Move> Board::legalMovesFor(Player p) const
 {
     std::vector<Move> out;
     // If the board is empty (no moves yet), fall back to scanning for all empties
@@ -442,7 +476,7 @@ std::vector<Move> Board::legalMoves(Player p, const RuleSet& rules) const
                 if (at(x, y) != Cell::Empty)
                     continue;
                 Move m { { x, y }, p };
-                if (pattern::createsIllegalDoubleThree(state, m, rules))
+                if (pattern::createsIllegalDoubleThree<P>(state, m))
                     continue;
                 out.push_back(m);
             }
@@ -452,23 +486,22 @@ std::vector<Move> Board::legalMoves(Player p, const RuleSet& rules) const
 
     // Otherwise, restrict to empties within Chebyshev distance <= 2 of any occupied cell
     // using the sparse occupied index to avoid scanning the whole board.
-    std::vector<uint8_t> mark(static_cast<std::size_t>(BOARD_SIZE * BOARD_SIZE), 0);
+    // Distance 2 == BoardState::PAD: the padded grid reads Wall past the edge, no bounds check.
+    Bitboard mark;
     out.reserve(256);
     for (const auto& s : state.occupied_) {
+        const int base = BoardState::slot(s);
         for (int dy = -2; dy <= 2; ++dy) {
             for (int dx = -2; dx <= 2; ++dx) {
-                int nx = static_cast<int>(s.x) + dx;
-                int ny = static_cast<int>(s.y) + dy;
-                if (!isInside(static_cast<uint8_t>(nx), static_cast<uint8_t>(ny)))
-                    continue;
-                if (at(static_cast<uint8_t>(nx), static_cast<uint8_t>(ny)) != Cell::Empty)
+                const int sl = base + dy * BoardState::STRIDE + dx;
+                if (state.cellAtSlot(sl) != Cell::Empty)
                     continue;
-                uint16_t id = BoardState::idx(static_cast<uint8_t>(nx), static_cast<uint8_t>(ny));
-                if (mark[id])
+                const uint16_t id = BoardState::idxOfSlot(sl);
+                if (mark.test(id))
                     continue;
-                mark[id] = 1;
-                Move m { { static_cast<uint8_t>(nx), static_cast<uint8_t>(ny) }, p };
-                if (pattern::createsIllegalDoubleThree(state, m, rules))
+                mark.set(id);
+                Move m { Pos::fromIndex(id), p };
+                if (pattern::createsIllegalDoubleThree<P>(state, m))
                     continue;
                 out.push_back(m);
             }
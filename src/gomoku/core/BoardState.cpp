@@ -1,6 +1,6 @@
 #include "gomoku/core/BoardState.hpp"
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 BoardState::BoardState()
 {
@@ -9,9 +9,21 @@ BoardState::BoardState()
 
 void BoardState::reset(bool sideToMoveBlack) noexcept
 {
-    cells.fill(Cell::Empty);
+    grid_.fill(Cell::Wall);
+    for (uint8_t y = 0; y < BOARD_SIZE; ++y)
+        for (uint8_t x = 0; x < BOARD_SIZE; ++x)
+            grid_[slot(x, y)] = Cell::Empty;
     occIdx_.fill(-1);
     occupied_.clear();
+    occupied_.reserve(N);
+    for (auto& bb : stones_)
+        bb.clear();
+    for (auto& perDir : lineBits_)
+        for (auto& words : perDir)
+            words.fill(0);
+    lineCode_ = lines::emptyCodes;
+    for (auto& perDir : fiveLines_)
+        perDir.fill(0);
     blackPairs = whitePairs = 0;
     blackStones = whiteStones = 0;
     zobristHash = 0ull;
@@ -24,7 +36,8 @@ void BoardState::reset(bool sideToMoveBlack) noexcept
 void BoardState::setCell(uint8_t x, uint8_t y, Cell c) noexcept
 {
     const uint16_t i = idx(x, y);
-    Cell prev = cells[i];
+    Cell& cell = grid_[slot(x, y)];
+    Cell prev = cell;
     if (prev == c)
         return;
 
@@ -38,7 +51,11 @@ void BoardState::setCell(uint8_t x, uint8_t y, Cell c) noexcept
     if (prev == Cell::Black) --blackStones;
     else if (prev == Cell::White) --whiteStones;
 
-    cells[i] = c;
+    if (prev != Cell::Empty)
+        toggleBits(i, prev);
+    if (c != Cell::Empty)
+        toggleBits(i, c);
+    cell = c;
 
     if (c == Cell::Black) ++blackStones;
     else if (c == Cell::White) ++whiteStones;
@@ -47,7 +64,8 @@ void BoardState::setCell(uint8_t x, uint8_t y, Cell c) noexcept
 void BoardState::clearCell(uint8_t x, uint8_t y) noexcept
 {
     const uint16_t i = idx(x, y);
-    Cell prev = cells[i];
+    Cell& cell = grid_[slot(x, y)];
+    Cell prev = cell;
     if (prev == Cell::Empty)
         return;
 
@@ -56,7 +74,21 @@ void BoardState::clearCell(uint8_t x, uint8_t y) noexcept
     if (prev == Cell::Black) --blackStones;
     else if (prev == Cell::White) --whiteStones;
 
-    cells[i] = Cell::Empty;
+    toggleBits(i, prev);
+    cell = Cell::Empty;
+}
+
+void BoardState::toggleBits(uint16_t i, Cell c) noexcept
+{
+    const int k = colorIndex(c);
+    stones_[k].w[i >> 6] ^= (1ull << (i & 63));
+    for (int d = 0; d < lines::DIRS; ++d) {
+        const lines::Coord lc = lines::coords[d][i];
+        const uint32_t word = (lineBits_[k][d][lc.line] ^= (1u << lc.bit));
+        const uint64_t lineBit = 1ull << lc.line;
+        fiveLines_[k][d] = lines::hasFive(word) ? (fiveLines_[k][d] | lineBit) : (fiveLines_[k][d] & ~lineBit);
+        lineCode_[d][lc.line] ^= (static_cast<uint64_t>(k + 1) << lines::codeShift(lc.bit));
+    }
 }
 
 void BoardState::addOccupied(Pos p) noexcept
@@ -1,71 +1,102 @@
 #include "gomoku/core/CaptureEngine.hpp"
+#include "gomoku/core/LineShapes.hpp"
 #include "gomoku/core/RayTables.hpp"
 
-namespace gomoku::capture {
+namespace gomoku::inline GOMOKU_SIZE_NS::capture {
+
+// 3-cell windows "OP OP who" read forward (cells +1..+3) and backward (cells -3..-1)
+static constexpr uint32_t captureFwd(Cell who, Cell opp) noexcept
+{
+    return shapes::code(opp) | (shapes::code(opp) << 2) | (shapes::code(who) << 4);
+}
+static constexpr uint32_t captureBwd(Cell who, Cell opp) noexcept
+{
+    return shapes::code(who) | (shapes::code(opp) << 2) | (shapes::code(opp) << 4);
+}
 
 int applyCapturesAround(BoardState& state, Pos p, Cell who,
-                        const RuleSet& rules, std::vector<Pos>& removed)
+                        const RuleSet& rules, CaptureBuffer& removed) noexcept
 {
-    if (!rules.capturesEnabled)
-        return 0;
+    return rules.capturesEnabled ? applyCaptures(state, p, who, removed) : 0;
+}
 
-    static constexpr int DX[4] = { 1, 0, 1, 1 };
-    static constexpr int DY[4] = { 0, 1, 1, -1 };
+int applyCaptures(BoardState& state, Pos p, Cell who, CaptureBuffer& removed) noexcept
+{
     const Cell opp = (who == Cell::Black ? Cell::White : Cell::Black);
+    const uint16_t i = BoardState::idx(p);
+    const uint32_t fwd = captureFwd(who, opp), bwd = captureBwd(who, opp);
     int pairs = 0;
 
-    auto isInside = [](uint8_t x, uint8_t y) {
-        return x < BOARD_SIZE && y < BOARD_SIZE;
-    };
-
-    auto tryDir = [&](int sx, int sy, int dx, int dy) -> bool {
-        int x1 = sx + dx,     y1 = sy + dy;
-        int x2 = sx + 2*dx,   y2 = sy + 2*dy;
-        int x3 = sx + 3*dx,   y3 = sy + 3*dy;
-
-        if (!isInside((uint8_t)x3, (uint8_t)y3))
-            return false;
-
-        auto at = [&](int x, int y) {
-            return state.getCell(Pos { static_cast<uint8_t>(x), static_cast<uint8_t>(y) });
-        };
+    for (int d = 0; d < 4; ++d) {
+        // The 7-cell window is read once per direction; captures along d never touch another direction's line
+        const uint32_t w = state.lineWindow(d, p, 3);
+        const auto& R = rays::capRaysByDir[d][i];
 
-        if (at(x1,y1) == opp && at(x2,y2) == opp && at(x3,y3) == who) {
-            state.removeStone({(uint8_t)x1, (uint8_t)y1});
-            state.removeStone({(uint8_t)x2, (uint8_t)y2});
-            removed.push_back({(uint8_t)x1, (uint8_t)y1});
-            removed.push_back({(uint8_t)x2, (uint8_t)y2});
-            return true;
+        // forward: who OP OP who
+        if (((w >> 8) & 0x3Fu) == fwd) {
+            const Pos a = Pos::fromIndex(R.fwd[0]), c = Pos::fromIndex(R.fwd[1]);
+            state.removeStone(a);
+            state.removeStone(c);
+            removed[2 * pairs] = a;
+            removed[2 * pairs + 1] = c;
+            ++pairs;
+        }
+        // backward: who OP OP who
+        if ((w & 0x3Fu) == bwd) {
+            const Pos a = Pos::fromIndex(R.bwd[0]), c = Pos::fromIndex(R.bwd[1]);
+            state.removeStone(a);
+            state.removeStone(c);
+            removed[2 * pairs] = a;
+            removed[2 * pairs + 1] = c;
+            ++pairs;
         }
-        return false;
-    };
-
-    for (int d = 0; d < 4; ++d) {
-        if (tryDir(p.x, p.y, DX[d], DY[d])) ++pairs; // forward
-        if (tryDir(p.x, p.y, -DX[d], -DY[d])) ++pairs; // backward
     }
     return pairs;
 }
 
-bool wouldCapture(const BoardState& state, Move m) noexcept
+int applyCapturesAround(BoardState& state, Pos p, Cell who,
+                        const RuleSet& rules, std::vector<Pos>& removed)
+{
+    CaptureBuffer buf;
+    const int pairs = applyCapturesAround(state, p, who, rules, buf);
+    removed.insert(removed.end(), buf.begin(), buf.begin() + 2 * pairs);
+    return pairs;
+}
+
+int findCaptures(const BoardState& state, Move m, CaptureBuffer& removed) noexcept
 {
     const Cell me  = playerToCell(m.by);
     const Cell opp = (me == Cell::Black ? Cell::White : Cell::Black);
     const uint16_t i = BoardState::idx(m.pos);
+    const uint32_t fwd = captureFwd(me, opp), bwd = captureBwd(me, opp);
+    int pairs = 0;
 
     for (int d = 0; d < 4; ++d) {
+        const uint32_t w = state.lineWindow(d, m.pos, 3);
         const auto& R = rays::capRaysByDir[d][i];
+        if (((w >> 8) & 0x3Fu) == fwd) {
+            removed[2 * pairs] = Pos::fromIndex(R.fwd[0]);
+            removed[2 * pairs + 1] = Pos::fromIndex(R.fwd[1]);
+            ++pairs;
+        }
+        if ((w & 0x3Fu) == bwd) {
+            removed[2 * pairs] = Pos::fromIndex(R.bwd[0]);
+            removed[2 * pairs + 1] = Pos::fromIndex(R.bwd[1]);
+            ++pairs;
+        }
+    }
+    return pairs;
+}
 
-        if (R.fwd[2] != 0xFFFF &&
-            state.getCell(Pos::fromIndex(R.fwd[2])) == me &&
-            state.getCell(Pos::fromIndex(R.fwd[0])) == opp &&
-            state.getCell(Pos::fromIndex(R.fwd[1])) == opp)
-            return true;
+bool wouldCapture(const BoardState& state, Move m) noexcept
+{
+    const Cell me  = playerToCell(m.by);
+    const Cell opp = (me == Cell::Black ? Cell::White : Cell::Black);
+    const uint32_t fwd = captureFwd(me, opp), bwd = captureBwd(me, opp);
 
-        if (R.bwd[2] != 0xFFFF &&
-            state.getCell(Pos::fromIndex(R.bwd[2])) == me &&
-            state.getCell(Pos::fromIndex(R.bwd[0])) == opp &&
-            state.getCell(Pos::fromIndex(R.bwd[1])) == opp)
+    for (int d = 0; d < 4; ++d) {
+        const uint32_t w = state.lineWindow(d, m.pos, 3);
+        if (((w >> 8) & 0x3Fu) == fwd || (w & 0x3Fu) == bwd)
             return true;
     }
     return false;
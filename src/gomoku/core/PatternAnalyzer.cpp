@@ -1,18 +1,96 @@
 #include "gomoku/core/PatternAnalyzer.hpp"
 #include "gomoku/core/CaptureEngine.hpp"
+#include "gomoku/core/LineShapes.hpp"
 #include "gomoku/core/RayTables.hpp"
+#include <array>
+#include <bit>
 
-namespace gomoku::pattern {
+namespace gomoku::inline GOMOKU_SIZE_NS::pattern {
 
-// --- helpers locaux sûrs (types int, cast explicite au dernier moment) ---
-static inline bool inside_int(int x, int y) noexcept
+// --- motifs de trois libres sur une fenêtre de 9 cases (offsets -4..+4, cf. BoardState::lineWindow) ---
+// '_' = vide, 'X' = ME, '?' = indifférent ; un mur n'est ni vide ni ME.
+struct Window9 {
+    uint32_t mask;
+    uint32_t value;
+};
+
+static constexpr Window9 window9(const char (&s)[10])
+{
+    Window9 p { 0, 0 };
+    for (int k = 0; k < 9; ++k) {
+        if (s[k] == '?')
+            continue;
+        p.mask |= 3u << (2 * k);
+        p.value |= (s[k] == 'X' ? shapes::OWN : shapes::EMPTY) << (2 * k);
+    }
+    return p;
+}
+
+static constexpr Window9 FREE_THREES[] = {
+    // 01110
+    window9("???_XXX_?"), window9("??_XXX_??"), window9("?_XXX_???"),
+    // 010110
+    window9("???_X_XX_"), window9("?_X_XX_??"), window9("_XX_X_???"),
+    // 011010
+    window9("???_XX_X_"), window9("??_XX_X_?"),
+};
+
+// --- table ternaire : une entrée par fenêtre de 9 cases (0 = vide, 1 = ME, 2 = OP ou mur) ---
+// index = sum(t_k * 3^k), case k = offset k - 4. Le centre est toujours ME (pierre posée) ;
+// les captures virtuelles (ME OP OP [centre] / [centre] OP OP ME) sont appliquées à la génération.
+static constexpr int TERNARY9 = 19683; // 3^9
+
+static constexpr std::array<uint16_t, 512> makePow3Masks()
+{
+    std::array<uint16_t, 512> t {};
+    for (uint32_t mask = 0; mask < t.size(); ++mask) {
+        int v = 0;
+        for (int k = 8; k >= 0; --k)
+            v = v * 3 + static_cast<int>((mask >> k) & 1u);
+        t[mask] = static_cast<uint16_t>(v);
+    }
+    return t;
+}
+// P3[mask] = somme des 3^k pour les bits k de mask
+static constexpr auto P3 = makePow3Masks();
+
+// Classification de référence : fenêtre vue par ME (format lineWindow, centre = ME),
+// captures virtuelles appliquées puis recherche des motifs de trois libres
+static constexpr bool freeThreeInWindow(uint32_t w)
 {
-    return x >= 0 && y >= 0 && x < BOARD_SIZE && y < BOARD_SIZE;
+    // captures virtuelles : les pierres prises sont sur la même ligne, on les vide
+    constexpr uint32_t CAPT_FWD = shapes::OTHER | (shapes::OTHER << 2) | (shapes::OWN << 4); // +1 +2 +3
+    constexpr uint32_t CAPT_BWD = shapes::OWN | (shapes::OTHER << 2) | (shapes::OTHER << 4); // -3 -2 -1
+    if (((w >> 10) & 0x3Fu) == CAPT_FWD)
+        w &= ~(0xFu << 10);
+    if (((w >> 2) & 0x3Fu) == CAPT_BWD)
+        w &= ~(0xFu << 4);
+
+    for (const Window9& p : FREE_THREES)
+        if ((w & p.mask) == p.value)
+            return true;
+    return false;
+}
+
+static constexpr bool isFreeThreeWindow(int index)
+{
+    uint32_t w = 0; // fenêtre au format lineWindow (2 bits par case)
+    for (int k = 0; k < 9; ++k, index /= 3) {
+        const int t = (k == 4) ? 1 : index % 3;
+        w |= static_cast<uint32_t>(t) << (2 * k);
+    }
+    return freeThreeInWindow(w);
 }
-static inline Cell at_int(const BoardState& st, int x, int y) noexcept
+
+static constexpr std::array<uint64_t, (TERNARY9 + 63) / 64> makeFreeThreeTable()
 {
-    return st.getCell(Pos { static_cast<uint8_t>(x), static_cast<uint8_t>(y) });
+    std::array<uint64_t, (TERNARY9 + 63) / 64> t {};
+    for (int i = 0; i < TERNARY9; ++i)
+        if (isFreeThreeWindow(i))
+            t[static_cast<std::size_t>(i >> 6)] |= 1ull << (i & 63);
+    return t;
 }
+static constexpr auto FREE_THREE_LUT = makeFreeThreeTable();
 
 bool createsIllegalDoubleThree(const BoardState& state, Move m, const RuleSet& rules)
 {
@@ -23,121 +101,70 @@ bool createsIllegalDoubleThree(const BoardState& state, Move m, const RuleSet& r
     if (rules.capturesEnabled && capture::wouldCapture(state, m))
         return false;
 
-    const Cell ME = playerToCell(m.by);
-    const Cell OP = (ME == Cell::Black ? Cell::White : Cell::Black);
-
-    // --- Captures virtuelles autour de m ---
-    uint16_t capturedIdx[8];
-    int captured_n = 0;
-
-    const uint16_t idx0 = BoardState::idx(m.pos);
-    for (int d = 0; d < 4; ++d) {
-        const auto& ray = rays::capRaysByDir[d][idx0];
-
-        // fwd: .. OP OP ME -> capture
-        if (ray.fwd[2] != 0xFFFF && state.getCell(Pos::fromIndex(ray.fwd[0])) == OP && state.getCell(Pos::fromIndex(ray.fwd[1])) == OP && state.getCell(Pos::fromIndex(ray.fwd[2])) == ME) {
-            capturedIdx[captured_n++] = ray.fwd[0];
-            capturedIdx[captured_n++] = ray.fwd[1];
-        }
-        // bwd: ME OP OP .. -> capture
-        if (ray.bwd[2] != 0xFFFF && state.getCell(Pos::fromIndex(ray.bwd[0])) == OP && state.getCell(Pos::fromIndex(ray.bwd[1])) == OP && state.getCell(Pos::fromIndex(ray.bwd[2])) == ME) {
-            capturedIdx[captured_n++] = ray.bwd[0];
-            capturedIdx[captured_n++] = ray.bwd[1];
-        }
-    }
-
-    auto isVirtuallyCaptured = [&](uint16_t id) noexcept {
-        for (int i = 0; i < captured_n; ++i)
-            if (capturedIdx[i] == id)
-                return true;
-        return false;
-    };
-
-    // lecture "virtuelle" tenant compte de la pierre posée et des captures virtuelles
-    auto vAt = [&](int x, int y) noexcept -> Cell {
-        if (!inside_int(x, y))
-            return OP; // mur = adversaire
-        const uint16_t id = BoardState::idx(static_cast<uint8_t>(x), static_cast<uint8_t>(y));
-        if (id == idx0)
-            return ME; // pierre qu'on pose
-        if (isVirtuallyCaptured(id))
-            return Cell::Empty; // retirée virtuellement
-        return state.getCell(Pos::fromIndex(id));
-    };
-
-    // motifs autour de (m.pos) sans buffer secondaire
-    auto hasThreeInLine = [&](int dx, int dy) noexcept -> bool {
-        int C[9]; // valeurs 0=vide, 1=ME, 2=OP aux offsets -4..+4
-        for (int off = -4, i = 0; off <= 4; ++off, ++i) {
-            const int x = static_cast<int>(m.pos.x) + off * dx;
-            const int y = static_cast<int>(m.pos.y) + off * dy;
-            const Cell c = vAt(x, y);
-            C[i] = (c == Cell::Empty) ? 0 : (c == ME ? 1 : 2);
-        }
-        auto Z = [&](int k) noexcept { return C[k + 4] == 0; };
-        auto O = [&](int k) noexcept { return C[k + 4] == 1; };
+    return formsDoubleThree(state, m);
+}
 
-        // 01110
-        if (Z(-1) && O(0) && O(+1) && O(+2) && Z(+3))
-            return true;
-        if (Z(-2) && O(-1) && O(0) && O(+1) && Z(+2))
-            return true;
-        if (Z(-3) && O(-2) && O(-1) && O(0) && Z(+1))
-            return true;
+// Lecture de la table pour la direction d : masques 9 bits des offsets -4..+4 tirés des mots
+// de ligne, hors plateau = OP (avant le bit 0, et après le bit 31 quand une ligne de 29 à
+// 32 cases pousse la fenêtre au-delà du mot de 32 bits)
+static inline bool freeThreeByTable(const BoardState& state, Cell me, uint16_t i0, int d) noexcept
+{
+    constexpr uint64_t WALLS = 0xFull | (~0ull << 36);
+    const Cell op = (me == Cell::Black ? Cell::White : Cell::Black);
+    const lines::Coord lc = lines::coords[d][i0];
+    const uint64_t mine = static_cast<uint64_t>(state.lineBits(me, d, lc.line)) << 4;
+    const uint64_t theirs = (static_cast<uint64_t>(state.lineBits(op, d, lc.line) | ~lines::valid[d][lc.line]) << 4) | WALLS;
+    const uint32_t own = static_cast<uint32_t>((mine >> lc.bit) & 0x1FFu) | (1u << 4);
+    const uint32_t other = static_cast<uint32_t>((theirs >> lc.bit) & 0x1FFu);
+
+    const int index = P3[own] + 2 * P3[other];
+    return (FREE_THREE_LUT[static_cast<std::size_t>(index >> 6)] >> (index & 63)) & 1ull;
+}
 
-        // 010110
-        if (Z(-1) && O(0) && Z(+1) && O(+2) && O(+3) && Z(+4))
-            return true;
-        if (Z(-3) && O(-2) && Z(-1) && O(0) && O(+1) && Z(+2))
-            return true;
-        if (Z(-4) && O(-3) && O(-2) && Z(-1) && O(0) && Z(+1))
-            return true;
+bool formsDoubleThree(const BoardState& state, Move m) noexcept
+{
+    const Cell ME = playerToCell(m.by);
+    const uint16_t i0 = BoardState::idx(m.pos);
 
-        // 011010
-        if (Z(-1) && O(0) && O(+1) && Z(+2) && O(+3) && Z(+4))
-            return true;
-        if (Z(-2) && O(-1) && O(0) && Z(+1) && O(+2) && Z(+3))
-            return true;
-        if (Z(-4) && O(-3) && O(-2) && Z(-1) && O(0) && Z(+1))
+    int threes = 0;
+    for (int d = 0; d < lines::DIRS; ++d) {
+        if (freeThreeByTable(state, ME, i0, d) && ++threes == 2)
             return true;
+    }
+    return false;
+}
 
-        return false;
-    };
+bool formsFreeThree(const BoardState& state, Move m, int d) noexcept
+{
+    return freeThreeByTable(state, playerToCell(m.by), BoardState::idx(m.pos), d);
+}
 
-    int threes = 0;
-    if (hasThreeInLine(1, 0) && ++threes == 2)
-        return true;
-    if (hasThreeInLine(0, 1) && ++threes == 2)
-        return true;
-    if (hasThreeInLine(1, 1) && ++threes == 2)
-        return true;
-    if (hasThreeInLine(1, -1) && ++threes == 2)
-        return true;
+bool formsFreeThreeScan(const BoardState& state, Move m, int d) noexcept
+{
+    // fenêtre vue par ME, pierre posée au centre
+    const Cell ME = playerToCell(m.by);
+    return freeThreeInWindow(shapes::withCell(shapes::relative(state.lineWindow(d, m.pos, 4), ME), 4, shapes::OWN));
+}
 
-    return false;
+uint8_t shapesThrough(const BoardState& state, Pos p, int d, Cell who) noexcept
+{
+    // 11 cases (offsets -5..+5), p au centre (case 5)
+    const uint32_t w = shapes::withCell(shapes::relative(state.lineWindow(d, p, 5), who), 5, shapes::OWN);
+    uint8_t flags = 0;
+    for (int s = 1; s <= 5; ++s) // fenêtres de 5 contenant p
+        flags |= shapes::shape5[(w >> (2 * s)) & 0x3FFu];
+    for (int s = 1; s <= 4; ++s) // fenêtres de 6 dont p est intérieur
+        flags |= shapes::shape6[(w >> (2 * s)) & 0xFFFu];
+    return flags;
 }
 
 bool checkFiveOrMoreFrom(const BoardState& state, Pos p, Cell who)
 {
-    static constexpr int DX[4] = { 1, 0, 1, 1 };
-    static constexpr int DY[4] = { 0, 1, 1, -1 };
-
+    const uint16_t i = BoardState::idx(p);
     for (int d = 0; d < 4; ++d) {
-        int count = 1;
-        for (int s = -1; s <= 1; s += 2) {
-            int x = p.x, y = p.y;
-            while (true) {
-                x += s * DX[d];
-                y += s * DY[d];
-                if (!inside_int(x, y))
-                    break;
-                if (at_int(state, x, y) == who)
-                    ++count;
-                else
-                    break;
-            }
-        }
-        if (count >= 5)
+        const int b = lines::coords[d][i].bit;
+        const uint32_t mine = state.lineBits(who, d, p) | (1u << b); // p counts as 'who'
+        if (lines::runUp(mine, b) + lines::runDown(mine, b) - 1 >= 5)
             return true;
     }
     return false;
@@ -145,80 +172,70 @@ bool checkFiveOrMoreFrom(const BoardState& state, Pos p, Cell who)
 
 bool hasAnyFive(const BoardState& state, Cell who)
 {
-    for (const auto& p : state.occupied_) {
-        if (state.getCell(p) == who) {
-            if (checkFiveOrMoreFrom(state, p, who))
+    return state.hasFive(who);
+}
+
+bool hasFiveAfterRemoving(const BoardState& state, Cell who, const Pos* removed, int n) noexcept
+{
+    for (int d = 0; d < lines::DIRS; ++d) {
+        uint64_t five = state.fiveLines(who, d);
+        while (five) {
+            const int line = std::countr_zero(five);
+            five &= five - 1;
+            uint32_t m = state.lineBits(who, d, line);
+            for (int k = 0; k < n; ++k) {
+                const lines::Coord lc = lines::coords[d][BoardState::idx(removed[k])];
+                if (lc.line == line)
+                    m &= ~(1u << lc.bit);
+            }
+            if (lines::hasFive(m))
                 return true;
         }
     }
     return false;
 }
 
-bool isFiveBreakableNow(const BoardState& stateIn, Player justPlayed, const RuleSet& rules)
+bool isFiveBreakableNow(const BoardState& state, Player justPlayed, const RuleSet& rules)
 {
-    if (!rules.capturesEnabled)
-        return false;
+    return rules.capturesEnabled && fiveBreakableByCapture(state, justPlayed, rules.captureWinPairs);
+}
 
+bool fiveBreakableByCapture(const BoardState& state, Player justPlayed, int captureWinPairs)
+{
     const Player opp = (justPlayed == Player::Black ? Player::White : Player::Black);
     const Cell meC = playerToCell(justPlayed);
+    const int oppPairs = (opp == Player::Black ? state.blackPairs : state.whitePairs);
 
-    // Copie de travail
-    BoardState state = stateIn;
-
-    static constexpr int DX[4] = { 1, 0, 1, 1 };
-    static constexpr int DY[4] = { 0, 1, 1, -1 };
-
-    std::vector<uint8_t> seen(static_cast<std::size_t>(BOARD_SIZE * BOARD_SIZE), 0);
-    std::vector<Pos> cand;
-    cand.reserve(128);
-
-    for (const auto& s : state.occupied_) {
-        if (state.getCell(s) != meC)
-            continue;
+    // Cases vides adjacentes (4 directions) aux pierres de 'justPlayed'
+    const Bitboard occ = state.occupancy();
+    Bitboard cand;
+    state.stones(meC).forEach([&](uint16_t s) {
         for (int d = 0; d < 4; ++d) {
-            // + direction
-            int nx1 = static_cast<int>(s.x) + DX[d];
-            int ny1 = static_cast<int>(s.y) + DY[d];
-            if (inside_int(nx1, ny1) && at_int(state, nx1, ny1) == Cell::Empty) {
-                const uint16_t id = BoardState::idx(static_cast<uint8_t>(nx1), static_cast<uint8_t>(ny1));
-                if (!seen[id]) {
-                    seen[id] = 1;
-                    cand.push_back(Pos { static_cast<uint8_t>(nx1), static_cast<uint8_t>(ny1) });
-                }
-            }
-            // - direction
-            int nx2 = static_cast<int>(s.x) - DX[d];
-            int ny2 = static_cast<int>(s.y) - DY[d];
-            if (inside_int(nx2, ny2) && at_int(state, nx2, ny2) == Cell::Empty) {
-                const uint16_t id = BoardState::idx(static_cast<uint8_t>(nx2), static_cast<uint8_t>(ny2));
-                if (!seen[id]) {
-                    seen[id] = 1;
-                    cand.push_back(Pos { static_cast<uint8_t>(nx2), static_cast<uint8_t>(ny2) });
-                }
-            }
+            const auto& R = rays::capRaysByDir[d][s];
+            if (R.fwd[0] != 0xFFFF && !occ.test(R.fwd[0]))
+                cand.set(R.fwd[0]);
+            if (R.bwd[0] != 0xFFFF && !occ.test(R.bwd[0]))
+                cand.set(R.bwd[0]);
         }
-    }
-
-    // Simule uniquement les coups adverses qui capturent
-    for (const auto& pos : cand) {
-        Move mv { pos, opp };
-        if (!capture::wouldCapture(state, mv))
-            continue;
-
-        BoardState sim = state;
-        sim.placeStone(mv.pos, playerToCell(opp));
-
-        std::vector<Pos> removed;
-        const int gained = capture::applyCapturesAround(sim, mv.pos, playerToCell(opp), rules, removed);
-
-        const int oppPairsAfter = (opp == Player::Black ? sim.blackPairs + gained : sim.whitePairs + gained);
-
-        if (oppPairsAfter >= rules.captureWinPairs)
-            return true; // victoire immédiate par capture
-        if (!hasAnyFive(sim, meC))
-            return true; // l'alignement 5+ est cassé par la capture
-    }
-    return false;
+    });
+
+    // Évalue les coups adverses qui capturent, sans copier l'état : on masque
+    // simplement les pierres prises sur les lignes qui portent un 5+
+    bool breakable = false;
+    cand.forEach([&](uint16_t id) {
+        if (breakable)
+            return;
+        capture::CaptureBuffer removed;
+        const int gained = capture::findCaptures(state, Move { Pos::fromIndex(id), opp }, removed);
+        if (gained == 0)
+            return;
+
+        if (oppPairs + gained >= captureWinPairs)
+            breakable = true; // victoire immédiate par capture
+        else if (!hasFiveAfterRemoving(state, meC, removed.data(), 2 * gained))
+            breakable = true; // l'alignement 5+ est cassé par la capture
+    });
+    return breakable;
 }
 
 } // namespace gomoku::pattern
@@ -2,7 +2,7 @@
 #include "gomoku/interfaces/IBoardView.hpp"
 #include <iostream>
 
-namespace gomoku {
+namespace gomoku::inline GOMOKU_SIZE_NS {
 
 std::ostream& operator<<(std::ostream& os, Player p)
 {
@@ -18,6 +18,8 @@ std::ostream& operator<<(std::ostream& os, Cell c)
         return os << "Black";
     case Cell::White:
         return os << "White";
+    case Cell::Wall:
+        return os << "Wall";
     }
     return os;
 }
@@ -51,6 +51,7 @@ GameScene::GameScene(Context& context, bool vsAi)
         // AI plays Black (first), Human plays White
         gameSession_.setController(gomoku::Player::Black, gomoku::Controller::AI);
         gameSession_.setController(gomoku::Player::White, gomoku::Controller::Human);
+        gameSession_.setPondering(true); // l'IA réfléchit pendant le tour du joueur
         pendingAi_ = true;
         framePresented_ = false; // wait for next render() before starting AI
     } else {
@@ -494,6 +495,7 @@ void GameScene::loadGame()
             gameSession_.setController(gomoku::Player::Black, gomoku::Controller::Human);
             gameSession_.setController(gomoku::Player::White, gomoku::Controller::Human);
         }
+        gameSession_.setPondering(vsAi_);
 
         auto result = gameSession_.load(boardData);
         if (result.ok) {
@@ -2,12 +2,30 @@
 #include "../framework/test_framework.hpp"
 #include "../utils/BoardBuilder.hpp"
 #include "../utils/BoardPrinter.hpp"
+#include "gomoku/ai/MctsSearchEngine.hpp"
 #include "gomoku/ai/MinimaxSearchEngine.hpp"
 #include "gomoku/ai/MoveOrderer.hpp"
+#include "gomoku/ai/NnueNetwork.hpp"
+#include "gomoku/ai/ProofNumberSearch.hpp"
+#include "gomoku/ai/SearchHelpers.hpp"
+#include "gomoku/ai/TranspositionPool.hpp"
+#include "gomoku/ai/TranspositionTable.hpp"
+#include "gomoku/application/GameService.hpp"
+#include "gomoku/application/SessionController.hpp"
+#include "gomoku/core/Zobrist.hpp"
 #include "gomoku/core/Board.hpp"
 #include "util/Logger.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 // Forward declaration
 void run_all_ai_improvements_tests();
@@ -254,7 +272,1287 @@ TEST(ai_principal_variation_populated)
     TEST_PASSED();
 }
 
+// Test 8: Lazy SMP - les helpers partagent la TT et leurs compteurs sont fusionnés
+TEST(ai_lazy_smp_search)
+{
+    std::cout << "\n=== Test: Recherche Lazy SMP (4 threads) ===" << std::endl;
+
+    Board board;
+    RuleSet rules {};
+
+    board.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 9, 10 }, Player::White }, rules);
+    board.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 8, 10 }, Player::White }, rules);
+    const uint64_t keyBefore = board.zobristKey();
+
+    SearchConfig config;
+    config.ttBytes = 16ull << 20;
+    MinimaxSearchEngine single(config);
+    config.threads = 4;
+    MinimaxSearchEngine smp(config);
+
+    SearchStats statsSingle, statsSmp;
+    auto moveSingle = single.findBestMove(board, rules, &statsSingle);
+    auto moveSmp = smp.findBestMove(board, rules, &statsSmp);
+    printSearchStats(statsSingle, "1 thread");
+    printSearchStats(statsSmp, "4 threads");
+
+    ASSERT_TRUE(moveSingle.has_value());
+    ASSERT_TRUE(moveSmp.has_value());
+    ASSERT_TRUE(board.isEmpty(moveSmp->pos.x, moveSmp->pos.y));
+    ASSERT_EQ(board.zobristKey(), keyBefore); // la position de l'appelant n'est pas modifiée
+    ASSERT_TRUE(statsSmp.depthReached >= 1);
+    ASSERT_TRUE(statsSmp.nodes > 0);
+
+    TEST_PASSED();
+}
+
+// Test 9: TT en buckets - les positions en collision cohabitent, l'entrée la plus faible cède sa place
+TEST(ai_tt_bucket_replacement)
+{
+    std::cout << "\n=== Test: TT en buckets (4 entrées / ligne de cache) ===" << std::endl;
+
+    using Flag = TranspositionTable::Flag;
+    TranspositionTable tt;
+    tt.resizeBytes(1); // taille minimale : 256 buckets
+    const uint64_t base = 0x9E3779B97F4A7C15ull & ~0xFFull;
+    const Move mv { Pos { 7, 8 }, Player::White };
+
+    // Quatre clés du même bucket : toutes retrouvées
+    for (int i = 0; i < TranspositionTable::BUCKET_SIZE; ++i)
+        tt.store(base + (static_cast<uint64_t>(i) << 8), 2 + i, -100 * i, Flag::Lower, mv);
+    TranspositionTable::Entry e;
+    for (int i = 0; i < TranspositionTable::BUCKET_SIZE; ++i) {
+        ASSERT_TRUE(tt.probe(base + (static_cast<uint64_t>(i) << 8), e));
+        ASSERT_EQ(e.depth, 2 + i);
+        ASSERT_EQ(e.score, -100 * i);
+        ASSERT_TRUE(e.flag == Flag::Lower);
+        ASSERT_TRUE(e.best == mv);
+    }
+
+    // Une cinquième clé remplace la moins profonde (depth 2) ; les autres restent
+    tt.store(base + (9ull << 8), 9, 1, Flag::Exact, std::nullopt);
+    ASSERT_FALSE(tt.probe(base, e));
+    ASSERT_TRUE(tt.probe(base + (9ull << 8), e));
+    ASSERT_FALSE(e.best.isValid());
+    ASSERT_TRUE(tt.probe(base + (3ull << 8), e));
+
+    // Même clé, moins profond, même recherche : l'entrée profonde est conservée
+    tt.store(base + (3ull << 8), 1, 42, Flag::Upper, std::nullopt);
+    ASSERT_TRUE(tt.probe(base + (3ull << 8), e));
+    ASSERT_EQ(e.depth, 5);
+
+    // Après plusieurs recherches, une entrée ancienne cède même face à moins profond
+    for (int i = 0; i < 3; ++i)
+        tt.newSearch();
+    tt.store(base + (3ull << 8), 1, 42, Flag::Upper, std::nullopt);
+    ASSERT_TRUE(tt.probe(base + (3ull << 8), e));
+    ASSERT_EQ(e.depth, 1);
+    ASSERT_TRUE(e.best == mv); // coup connu conservé pour l'ordonnancement
+
+    TEST_PASSED();
+}
+
+// Test 10: clear() en O(1) - les entrées antérieures deviennent invisibles
+TEST(ai_tt_generation_clear)
+{
+    std::cout << "\n=== Test: vidage de la TT par génération ===" << std::endl;
+
+    using Flag = TranspositionTable::Flag;
+    TranspositionTable tt;
+    tt.resizeBytes(128ull << 20);
+    ASSERT_EQ(tt.bytes(), static_cast<std::size_t>(128ull << 20));
+
+    const uint64_t key = 0x0123456789ABCDEFull;
+    TranspositionTable::Entry e;
+    ASSERT_FALSE(tt.probe(key, e)); // pages neuves = table vide
+    tt.store(key, 6, 77, Flag::Exact, Move { Pos { 3, 4 }, Player::Black });
+    ASSERT_TRUE(tt.probe(key, e));
+
+    // Entrées de générations variées avant le vidage (fenêtre vivante large)
+    for (uint64_t i = 1; i <= 100; ++i) {
+        tt.newSearch();
+        tt.store(key + (i << 8), 3, static_cast<int>(i), Flag::Lower, std::nullopt);
+    }
+
+    tt.clear();
+    ASSERT_FALSE(tt.probe(key, e));
+    // Plusieurs tours complets des générations 8 bits : rien ne revient
+    for (int i = 0; i < 1000; ++i) {
+        tt.newSearch();
+        if (i % 50 == 0 || (i >= 250 && i <= 260)) {
+            ASSERT_FALSE(tt.probe(key, e));
+            for (uint64_t k = 1; k <= 100; ++k)
+                ASSERT_FALSE(tt.probe(key + (k << 8), e));
+        }
+    }
+
+    // Sans vidage : une entrée plus vieille que LIVE_SPAN recherches disparaît pour de bon
+    const uint64_t aged = key ^ 0xFFFF000000000000ull;
+    tt.store(aged, 4, 9, Flag::Exact, std::nullopt);
+    for (int i = 0; i < TranspositionTable::LIVE_SPAN - 1; ++i)
+        tt.newSearch();
+    ASSERT_TRUE(tt.probe(aged, e));
+    for (int i = 0; i < 600; ++i) {
+        tt.newSearch();
+        ASSERT_FALSE(tt.probe(aged, e));
+    }
+
+    // L'emplacement périmé est réutilisé comme un slot vide
+    tt.store(key, 2, -5, Flag::Upper, std::nullopt);
+    ASSERT_TRUE(tt.probe(key, e));
+    ASSERT_EQ(e.depth, 2);
+    ASSERT_EQ(e.score, -5);
+    ASSERT_FALSE(e.best.isValid());
+
+    // Même taille : resizeBytes se contente de vider
+    tt.resizeBytes(128ull << 20);
+    ASSERT_FALSE(tt.probe(key, e));
+
+    // newSearch() concurrents (sessions sur la table du pool) : la fenêtre vivante ne dépasse
+    // jamais LIVE_SPAN, même quand plusieurs incréments passent entre lecture et CAS
+    TranspositionTable small;
+    small.resizeBytes(1ull << 20);
+    for (int round = 0; round < 200; ++round) {
+        const uint64_t k = key + (static_cast<uint64_t>(round) << 20);
+        small.store(k, 1, round, Flag::Exact, std::nullopt);
+        std::vector<std::thread> bumpers;
+        for (int t = 0; t < 8; ++t)
+            bumpers.emplace_back([&small] {
+                for (int i = 0; i < TranspositionTable::LIVE_SPAN / 8 + 4; ++i)
+                    small.newSearch();
+            });
+        for (auto& t : bumpers)
+            t.join();
+        ASSERT_FALSE(small.probe(k, e));
+    }
+
+    TEST_PASSED();
+}
+
+// Test 11: TT partagée - toutes les sessions tiennent dans le budget du pool
+TEST(ai_tt_pool_shared_budget)
+{
+    std::cout << "\n=== Test: pool de TT partagé entre sessions ===" << std::endl;
+
+    ASSERT_EQ(ttpool::liveBytes(), static_cast<std::size_t>(0));
+    ttpool::setBudgetBytes(100ull << 20);
+    {
+        std::vector<std::unique_ptr<SessionController>> sessions;
+        for (int i = 0; i < 8; ++i)
+            sessions.push_back(std::make_unique<SessionController>());
+        // Une seule table, arrondie sous le budget, quel que soit le nombre de sessions
+        ASSERT_EQ(ttpool::liveBytes(), static_cast<std::size_t>(64ull << 20));
+
+        auto r = sessions[0]->playAI(100);
+        ASSERT_TRUE(r.ok);
+        ASSERT_EQ(ttpool::liveBytes(), static_cast<std::size_t>(64ull << 20));
+
+        // Une taille explicite fait sortir le moteur du pool
+        SearchConfig cfg;
+        cfg.sharedTT = true;
+        MinimaxSearchEngine engine(cfg);
+        ASSERT_TRUE(ttpool::acquire().use_count() > 1);
+        engine.setTranspositionTableSize(1u << 20);
+    }
+    ASSERT_EQ(ttpool::liveBytes(), static_cast<std::size_t>(0)); // libérée avec la dernière session
+
+    // Budget sous la plus petite table : relevé à 16 KB, jamais dépassé en silence
+    ttpool::setBudgetBytes(1000);
+    ASSERT_EQ(ttpool::budgetBytes(), TranspositionTable::MIN_BYTES);
+    {
+        const auto tiny = ttpool::acquire();
+        ASSERT_EQ(tiny->bytes(), TranspositionTable::MIN_BYTES);
+        ASSERT_TRUE(ttpool::liveBytes() <= ttpool::budgetBytes());
+    }
+    ttpool::setBudgetBytes(ttpool::DEFAULT_BUDGET_BYTES);
+
+    // Les clés TT distinguent les jeux de règles
+    RuleSet noCaptures {};
+    noCaptures.capturesEnabled = false;
+    ASSERT_NE(zobrist::rules(RuleSet {}), zobrist::rules(noCaptures));
+
+    TEST_PASSED();
+}
+
+// Test 12: TT persistante - sauvegarde/rechargement, fichiers d'autres règles ou corrompus refusés
+TEST(ai_tt_file_warm_start)
+{
+    std::cout << "\n=== Test: TT persistante sur disque ===" << std::endl;
+
+    using Flag = TranspositionTable::Flag;
+    const std::string path = (std::filesystem::temp_directory_path() / "gomoku_tt_test.bin").string();
+    RuleSet rules {};
+    RuleSet noCaptures {};
+    noCaptures.capturesEnabled = false;
+    const uint64_t fp = search::ttFingerprint(rules);
+    ASSERT_NE(fp, search::ttFingerprint(noCaptures));
+
+    const uint64_t keyA = 0x1111222233334444ull;
+    const uint64_t keyB = 0x5555666677778888ull;
+    {
+        TranspositionTable tt;
+        tt.resizeBytes(1u << 20);
+        tt.store(keyA, 7, 123, Flag::Lower, Move { Pos { 9, 10 }, Player::White });
+        tt.newSearch();
+        tt.store(keyB, 3, -40, Flag::Exact, std::nullopt);
+        ASSERT_TRUE(tt.saveFile(path, fp));
+    }
+
+    TranspositionTable loaded;
+    loaded.resizeBytes(4u << 20);
+    ASSERT_FALSE(loaded.loadFile(path, search::ttFingerprint(noCaptures)));
+    ASSERT_EQ(loaded.bytes(), static_cast<std::size_t>(4u << 20)); // refus : table inchangée
+    ASSERT_TRUE(loaded.loadFile(path, fp));
+    ASSERT_EQ(loaded.bytes(), static_cast<std::size_t>(1u << 20)); // la taille du fichier l'emporte
+    TranspositionTable::Entry e;
+    ASSERT_TRUE(loaded.probe(keyA, e));
+    ASSERT_EQ(e.depth, 7);
+    ASSERT_EQ(e.score, 123);
+    ASSERT_TRUE(e.flag == Flag::Lower);
+    ASSERT_EQ(e.best.pos.x, 9);
+    ASSERT_EQ(e.best.pos.y, 10);
+    ASSERT_TRUE(loaded.probe(keyB, e));
+    ASSERT_EQ(e.score, -40);
+    // Copie privée : les écritures ne touchent pas le fichier
+    loaded.clear();
+    ASSERT_FALSE(loaded.probe(keyA, e));
+    loaded.store(keyA, 1, 0, Flag::Upper, std::nullopt);
+
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(0);
+        f.put('X');
+    }
+    ASSERT_FALSE(loaded.loadFile(path, fp));
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f << "GMKTTAB";
+    }
+    ASSERT_FALSE(loaded.loadFile(path, fp));
+    ASSERT_FALSE(loaded.loadFile(path + ".absent", fp));
+
+    // Recherche : le fichier sauvé explicitement réchauffe la recherche suivante
+    std::remove(path.c_str());
+    Board board;
+    board.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 10, 10 }, Player::White }, rules);
+    board.tryPlay(Move { { 8, 10 }, Player::Black }, rules);
+    SearchConfig cfg;
+    cfg.timeBudgetMs = 60'000;
+    cfg.maxDepthHint = 4;
+    cfg.ttBytes = 1u << 20;
+    cfg.ttFile = path;
+    SearchStats cold, warm;
+    {
+        MinimaxSearch search(cfg);
+        ASSERT_FALSE(search.saveTranspositionTable()); // aucune recherche : règles inconnues
+        ASSERT_TRUE(search.bestMove(board, rules, &cold).has_value());
+    }
+    ASSERT_FALSE(std::filesystem::exists(path)); // la destruction n'écrit rien
+    {
+        MinimaxSearch search(cfg);
+        ASSERT_TRUE(search.bestMove(board, rules, &cold).has_value());
+        ASSERT_TRUE(search.saveTranspositionTable());
+    }
+    ASSERT_TRUE(std::filesystem::exists(path));
+    {
+        MinimaxSearch search(cfg);
+        ASSERT_TRUE(search.bestMove(board, rules, &warm).has_value());
+    }
+    printSearchStats(cold, "Cold");
+    printSearchStats(warm, "Warm");
+    ASSERT_TRUE(warm.nodes < cold.nodes);
+    std::remove(path.c_str());
+
+    TEST_PASSED();
+}
+
+// Test 13: Pondering - la recherche du coup attendu continue après un ponder hit, un miss l'abandonne
+TEST(ai_pondering_hit_and_miss)
+{
+    std::cout << "\n=== Test: réflexion pendant le temps adverse ===" << std::endl;
+    using namespace std::chrono;
+
+    SearchConfig cfg;
+    cfg.ttBytes = 16ull << 20;
+    cfg.maxDepthHint = 30; // seul le temps arrête la recherche
+    application::GameService game(std::make_unique<MinimaxSearchEngine>(cfg));
+    game.startNewGame(RuleSet {});
+    ASSERT_TRUE(game.makeMove(Move { { 9, 9 }, Player::Black }).success);
+    auto aiMove = game.getAIMove(100);
+    ASSERT_TRUE(aiMove.has_value());
+    ASSERT_TRUE(game.makeMove(*aiMove).success);
+
+    // Ponder hit : le temps de réflexion adverse s'ajoute à la recherche
+    const Move expected { { 10, 10 }, Player::Black };
+    ASSERT_FALSE(game.startPondering({ expected, expected })); // pv[0] doit être le dernier coup joué
+    ASSERT_TRUE(game.startPondering({ *aiMove, expected }));
+    ASSERT_TRUE(game.isPondering());
+    std::this_thread::sleep_for(milliseconds(300));
+    ASSERT_TRUE(game.makeMove(expected).success);
+    ASSERT_TRUE(game.isPondering());
+
+    SearchStats hitStats;
+    auto t0 = steady_clock::now();
+    auto reply = game.getAIMove(1, &hitStats); // 1 ms : seule la réflexion déjà faite compte
+    const auto hitLatency = duration_cast<milliseconds>(steady_clock::now() - t0).count();
+    printSearchStats(hitStats, "Ponder hit");
+    std::cout << "    Latency:   " << hitLatency << "ms" << std::endl;
+    ASSERT_TRUE(reply.has_value());
+    ASSERT_TRUE(reply->by == Player::White);
+    ASSERT_TRUE(hitStats.depthReached >= 3); // profondeur acquise pendant le temps adverse
+    ASSERT_TRUE(hitLatency < 100);
+    ASSERT_FALSE(game.isPondering());
+    ASSERT_TRUE(game.makeMove(*reply).success);
+
+    // Ponder miss : abandon immédiat, recherche normale sur la position réelle
+    ASSERT_TRUE(game.startPondering({ *reply, Move { { 12, 12 }, Player::Black } }));
+    std::this_thread::sleep_for(milliseconds(100));
+    ASSERT_TRUE(game.makeMove(Move { { 6, 6 }, Player::Black }).success);
+    ASSERT_FALSE(game.isPondering());
+    SearchStats missStats;
+    reply = game.getAIMove(100, &missStats);
+    ASSERT_TRUE(reply.has_value());
+    ASSERT_TRUE(missStats.timeMs < 300);
+
+    // Un retour arrière abandonne aussi la réflexion
+    ASSERT_TRUE(game.makeMove(*reply).success);
+    ASSERT_TRUE(game.startPondering({ *reply, Move { { 12, 12 }, Player::Black } }));
+    ASSERT_TRUE(game.undo());
+    ASSERT_FALSE(game.isPondering());
+
+    // Session : la réflexion démarre après chaque coup IA face à un humain
+    SessionController session;
+    session.setPondering(true);
+    ASSERT_TRUE(session.playHuman(Pos { 9, 9 }).ok);
+    ASSERT_TRUE(session.playAI(100).ok);
+    ASSERT_TRUE(session.playHuman(Pos { 2, 2 }).ok);
+    ASSERT_TRUE(session.playAI(100).ok);
+
+    // Les aides d'analyse restent utilisables depuis un autre thread pendant la réflexion
+    RuleSet rules {};
+    Board pos;
+    pos.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    pos.tryPlay(Move { { 10, 10 }, Player::White }, rules);
+    pos.tryPlay(Move { { 8, 10 }, Player::Black }, rules);
+    MinimaxSearch search(cfg);
+    const int score = search.evaluatePublic(pos, Player::White);
+    const auto ordered = search.orderedMovesPublic(pos, rules, Player::White);
+    search.startPonder(pos, rules);
+    const auto until = steady_clock::now() + milliseconds(200);
+    int calls = 0;
+    while (steady_clock::now() < until) {
+        ASSERT_EQ(search.evaluatePublic(pos, Player::White), score);
+        ASSERT_TRUE(search.orderedMovesPublic(pos, rules, Player::White) == ordered);
+        ++calls;
+    }
+    ASSERT_TRUE(search.isPondering());
+    SearchStats ponderStats;
+    ASSERT_TRUE(search.ponderHit(1, &ponderStats).has_value());
+    std::cout << "    Analyses pendant la réflexion: " << calls << ", profondeur " << ponderStats.depthReached << std::endl;
+
+    TEST_PASSED();
+}
+
+// Test 14: Gestion du temps - limites soft/hard, arrêt anticipé sur position stable ou gagnée
+TEST(ai_time_manager)
+{
+    std::cout << "\n=== Test: gestion adaptative du temps ===" << std::endl;
+    using namespace std::chrono;
+
+    // Budget fixe : hard = budget, visé = softTimePercent
+    auto l = TimeManager::allocate(1000, GameClock {}, 50);
+    ASSERT_EQ(l.hardMs, 1000);
+    ASSERT_EQ(l.optimumMs, 500);
+    // Pendule : part du temps restant + incrément, jamais plus de la moitié du restant
+    l = TimeManager::allocate(1000, GameClock { 60'000, 0, 0 }, 50);
+    ASSERT_TRUE(l.optimumMs >= 1500 && l.optimumMs <= 2500);
+    ASSERT_TRUE(l.hardMs > l.optimumMs && l.hardMs <= 30'000);
+    const auto withIncrement = TimeManager::allocate(1000, GameClock { 60'000, 2'000, 0 }, 50);
+    ASSERT_TRUE(withIncrement.optimumMs > l.optimumMs);
+    l = TimeManager::allocate(1000, GameClock { 3'000, 0, 1 }, 50); // dernier coup avant le contrôle
+    ASSERT_TRUE(l.hardMs >= 2'900 && l.hardMs < 3'000);
+
+    const Move a { { 9, 9 }, Player::Black };
+    const Move b { { 10, 10 }, Player::Black };
+    const TimeManager::Limits limits { 400, 1000 };
+    const auto t0 = steady_clock::now();
+    const SearchDeadline deadline { t0 + milliseconds(1000) };
+    const auto at = [&](int ms) { return t0 + milliseconds(ms); };
+
+    // Coup stable : la fenêtre se réduit jusqu'à la moitié du temps visé
+    TimeManager stable(limits, deadline);
+    for (int i = 0; i < 3; ++i)
+        ASSERT_FALSE(stable.iterationDone(a, 100, 0.5, at(10)));
+    ASSERT_TRUE(stable.iterationDone(a, 120, 0.5, at(250)));
+    ASSERT_TRUE(stable.scale() < 1.0);
+
+    // Meilleur coup qui change et score qui chute : on prolonge au-delà du temps visé
+    TimeManager unstable(limits, deadline);
+    ASSERT_FALSE(unstable.iterationDone(a, 100, 0.5, at(10)));
+    ASSERT_FALSE(unstable.iterationDone(b, -2000, 0.5, at(450)));
+    ASSERT_TRUE(unstable.scale() > 2.0);
+
+    // Un coup qui absorbe presque tous les nœuds : arrêt plus tôt
+    TimeManager dominant(limits, deadline);
+    ASSERT_TRUE(dominant.iterationDone(a, 100, 0.95, at(300)));
+
+    // Réflexion (échéance infinie) : jamais d'arrêt soft
+    const SearchDeadline ponder { SearchDeadline::clock::time_point::max() };
+    TimeManager pondering(limits, ponder);
+    for (int i = 0; i < 5; ++i)
+        ASSERT_FALSE(pondering.iterationDone(a, 100, 0.95, at(5000)));
+
+    // Ponder hit : la fenêtre soft suit les limites du coup joué, pas celles de la réflexion
+    SearchDeadline hitDeadline { SearchDeadline::clock::time_point::max() };
+    TimeManager hit(TimeManager::Limits { 10'000, 20'000 }, hitDeadline);
+    ASSERT_FALSE(hit.iterationDone(a, 100, 0.5, at(10)));
+    hit.setLimits(limits);
+    hitDeadline.set(t0 + milliseconds(1000));
+    ASSERT_FALSE(hit.iterationDone(a, 100, 0.5, at(200)));
+    ASSERT_TRUE(hit.iterationDone(a, 100, 0.5, at(600)));
+
+    // Recherche : un gain forcé est joué sans consommer le budget
+    Board board;
+    RuleSet rules {};
+    board.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 0, 0 }, Player::White }, rules);
+    board.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 0, 18 }, Player::White }, rules);
+    board.tryPlay(Move { { 11, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 18, 0 }, Player::White }, rules);
+    SearchConfig cfg;
+    cfg.timeBudgetMs = 5000;
+    cfg.ttBytes = 16ull << 20;
+    cfg.adaptiveTime = true;
+    MinimaxSearch search(cfg);
+    SearchStats stats;
+    auto t1 = steady_clock::now();
+    auto move = search.bestMove(board, rules, &stats);
+    const auto spent = duration_cast<milliseconds>(steady_clock::now() - t1).count();
+    printSearchStats(stats, "Gain forcé, budget 5 s");
+    ASSERT_TRUE(move.has_value());
+    ASSERT_EQ(move->pos.y, 9);
+    ASSERT_TRUE(move->pos.x == 8 || move->pos.x == 12);
+    ASSERT_TRUE(spent < 2500);
+
+    // Session à la pendule : l'IA joue sur sa part du temps restant, chaque camp est décompté
+    SessionController session;
+    session.setTimeControl(2000, 50);
+    ASSERT_TRUE(session.playHuman(Pos { 9, 9 }).ok);
+    ASSERT_TRUE(session.clock(Player::Black).remainingMs <= 2050);
+    const auto share = TimeManager::allocate(5000, GameClock { 2000, 50, 0 }, cfg.softTimePercent);
+    t1 = steady_clock::now();
+    const auto played = session.playAI(5000); // budget fixe ignoré : la pendule l'emporte
+    const auto aiSpent = duration_cast<milliseconds>(steady_clock::now() - t1).count();
+    ASSERT_TRUE(played.ok);
+    std::cout << "    Pendule: IA " << aiSpent << " ms (hard " << share.hardMs << " ms), reste "
+              << session.clock(Player::White).remainingMs << " ms" << std::endl;
+    ASSERT_TRUE(aiSpent < share.hardMs + 200);
+    ASSERT_TRUE(session.clock(Player::White).remainingMs <= 2050);
+    ASSERT_TRUE(session.clock(Player::White).remainingMs >= 2050 - aiSpent - 50);
+    session.reset();
+    ASSERT_EQ(session.clock(Player::White).remainingMs, 2000);
+
+    TEST_PASSED();
+}
+
+// Test 15: Arrêt coopératif - stop() externe, horloge lue tous les N nœuds, abandon propre
+TEST(ai_stop_token_and_polling)
+{
+    std::cout << "\n=== Test: arrêt coopératif de la recherche ===" << std::endl;
+    using namespace std::chrono;
+
+    // Le drapeau et l'horloge ne sont lus qu'une fois tous les pollInterval nœuds
+    RuleSet rules {};
+    std::atomic<bool> stopFlag { false };
+    const SearchDeadline later { steady_clock::now() + seconds(60) };
+    SearchStats counters;
+    const SearchContext ctx { rules, later, &counters, 0, &stopFlag, 100 };
+    ASSERT_FALSE(ctx.isTimeUp()); // première lecture
+    stopFlag.store(true);
+    for (int i = 0; i < 99; ++i) {
+        ctx.recordNode();
+        ASSERT_FALSE(ctx.isTimeUp());
+    }
+    ctx.recordNode();
+    ASSERT_TRUE(ctx.isTimeUp());
+    stopFlag.store(false);
+    ASSERT_TRUE(ctx.isTimeUp()); // l'abandon est définitif
+    ASSERT_TRUE(ctx.stopped());
+
+    // La limite de nœuds reste exacte
+    SearchStats capped;
+    const SearchContext capCtx { rules, later, &capped, 10, nullptr, 4096 };
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_FALSE(capCtx.isTimeUp());
+        capCtx.recordNode();
+    }
+    ASSERT_TRUE(capCtx.isTimeUp());
+
+    Board board;
+    board.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 9, 10 }, Player::White }, rules);
+    board.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 8, 10 }, Player::White }, rules);
+
+    // stop() depuis un autre thread : la recherche rend la main avec son meilleur coup
+    SearchConfig cfg;
+    cfg.timeBudgetMs = 20'000;
+    cfg.maxDepthHint = 30;
+    cfg.adaptiveTime = false;
+    cfg.ttBytes = 16ull << 20;
+    MinimaxSearchEngine engine(cfg);
+    std::thread stopper([&engine] {
+        std::this_thread::sleep_for(milliseconds(200));
+        engine.stop();
+    });
+    SearchStats stats;
+    const auto t0 = steady_clock::now();
+    auto move = engine.findBestMove(board, rules, &stats);
+    const auto spent = duration_cast<milliseconds>(steady_clock::now() - t0).count();
+    stopper.join();
+    printSearchStats(stats, "stop() après 200 ms");
+    ASSERT_TRUE(move.has_value());
+    ASSERT_TRUE(board.isEmpty(move->pos.x, move->pos.y));
+    ASSERT_TRUE(spent < 2000);
+    ASSERT_FALSE(stats.principalVariation.empty());
+    ASSERT_TRUE(stats.principalVariation.front() == *move);
+
+    // Budget de nœuds épuisé : abandon sans dépasser la limite
+    cfg.nodeCap = 3000;
+    MinimaxSearch capSearch(cfg);
+    SearchStats capStats;
+    move = capSearch.bestMove(board, rules, &capStats);
+    ASSERT_TRUE(move.has_value());
+    ASSERT_TRUE(capStats.nodes <= 3000 + 64);
+    ASSERT_TRUE(capStats.depthReached >= 1);
+
+    // stop() reçu avant bestMove() : pas perdu, il abandonne cette recherche et elle seule
+    cfg.nodeCap = 0;
+    cfg.maxDepthHint = 4;
+    MinimaxSearch early(cfg);
+    early.stop();
+    SearchStats earlyStats;
+    const auto t1 = steady_clock::now();
+    early.bestMove(board, rules, &earlyStats);
+    ASSERT_TRUE(duration_cast<milliseconds>(steady_clock::now() - t1).count() < 500);
+    ASSERT_TRUE(earlyStats.depthReached <= 1);
+    move = early.bestMove(board, rules, &earlyStats);
+    ASSERT_TRUE(move.has_value());
+    ASSERT_TRUE(earlyStats.depthReached == 4);
+
+    TEST_PASSED();
+}
+
+// Test 16: Budget de nœuds - résultat reproductible, limite dure qsearch comprise, horloge ignorée
+TEST(ai_node_budget_search)
+{
+    std::cout << "\n=== Test: recherche à budget de nœuds ===" << std::endl;
+
+    RuleSet rules {};
+    Board board;
+    board.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 9, 10 }, Player::White }, rules);
+    board.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 8, 10 }, Player::White }, rules);
+
+    // Budget de temps dérisoire et horloge presque vide : seul le budget de nœuds compte
+    SearchConfig cfg;
+    cfg.timeBudgetMs = 1;
+    cfg.clock = GameClock { 5, 0, 0 };
+    cfg.maxDepthHint = 30;
+    cfg.ttBytes = 16ull << 20;
+    cfg.nodeBudget = 20'000;
+
+    MinimaxSearch first(cfg);
+    SearchStats a;
+    const auto moveA = first.bestMove(board, rules, &a);
+    printSearchStats(a, "budget 20000 nœuds");
+    ASSERT_TRUE(moveA.has_value());
+    ASSERT_TRUE(a.nodes + a.qnodes <= 20'000);
+    ASSERT_EQ(a.nodeBudgetOverrun, 0);
+    ASSERT_TRUE(a.nodes + a.qnodes > 10'000); // le budget est consommé, pas l'horloge
+
+    // Même budget, même position : même coup, même arbre
+    MinimaxSearch second(cfg);
+    SearchStats b;
+    const auto moveB = second.bestMove(board, rules, &b);
+    ASSERT_TRUE(moveB.has_value());
+    ASSERT_TRUE(*moveA == *moveB);
+    ASSERT_EQ(a.nodes, b.nodes);
+    ASSERT_EQ(a.qnodes, b.qnodes);
+    ASSERT_EQ(a.depthReached, b.depthReached);
+
+    // La limite est appliquée même sans statistiques demandées
+    MinimaxSearch blind(cfg);
+    const auto moveC = blind.bestMove(board, rules, nullptr);
+    ASSERT_TRUE(moveC.has_value());
+    ASSERT_TRUE(*moveC == *moveA);
+
+    // Sélection via l'interface du moteur ; nodeCap plus bas l'emporte
+    MinimaxSearchEngine engine(SearchConfig {});
+    engine.setNodeBudget(20'000);
+    SearchStats viaEngine;
+    const auto moveD = engine.findBestMove(board, rules, &viaEngine);
+    ASSERT_TRUE(moveD.has_value());
+    ASSERT_TRUE(viaEngine.nodes + viaEngine.qnodes <= 20'000);
+
+    cfg.nodeCap = 5'000;
+    MinimaxSearch capped(cfg);
+    SearchStats c;
+    ASSERT_TRUE(capped.bestMove(board, rules, &c).has_value());
+    ASSERT_TRUE(c.nodes + c.qnodes + c.threatNodes + c.raceNodes <= 5'000);
+
+    // Solveur de menaces et oracle de course actifs : leurs nœuds sont pris sur le budget
+    RuleSet raceRules {};
+    raceRules.captureWinPairs = 2;
+    Board race;
+    test_utils::set_board(race, R"(
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . O O . . . . .
+        . . . . . O . . . . . . .
+        . . . . . O . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . X O O
+    )");
+    race.forceSide(Player::Black);
+    ASSERT_TRUE(race.tryPlay(Move { { 13, 10 }, Player::Black }, raceRules)); // 1re paire
+    ASSERT_TRUE(race.tryPlay(Move { { 15, 15 }, Player::White }, raceRules));
+    ASSERT_TRUE(race.tryPlay(Move { { 0, 18 }, Player::Black }, raceRules)); // rien de forcé
+    cfg.nodeCap = 0;
+    cfg.nodeBudget = 8'000;
+    cfg.useThreatSearch = true;
+    cfg.useCaptureRace = true;
+    cfg.captureRaceMinDepth = 1;
+    for (const int threads : { 1, 2 }) {
+        cfg.threads = threads;
+        MinimaxSearch solvers(cfg);
+        SearchStats s;
+        ASSERT_TRUE(solvers.bestMove(race, raceRules, &s).has_value());
+        printSearchStats(s, threads == 1 ? "budget 8000, solveurs actifs" : "budget 8000, solveurs actifs, 2 threads");
+        ASSERT_TRUE(s.threatNodes > 0);
+        ASSERT_TRUE(s.raceNodes > 0);
+        ASSERT_TRUE(s.nodes + s.qnodes + s.threatNodes + s.raceNodes <= 8'000);
+        ASSERT_EQ(s.nodeBudgetOverrun, 0);
+    }
+
+    TEST_PASSED();
+}
+
+// Test 17: Recherche dans l'espace des menaces - VCF trouvé, parade par capture, position calme
+TEST(ai_threat_space_search)
+{
+    std::cout << "\n=== Test: solveur VCF/VCT ===" << std::endl;
+
+    RuleSet rules {};
+
+    // Double quatre en (8,5) : ligne fermée par O + colonne à trou
+    Board fork;
+    test_utils::set_board(fork, R"(
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . O X X X . .
+        . . . . . . . . . .
+        . . . . . . . . X .
+        . . . . . . . . X .
+        . . . . . . . . X .
+        . . . . . . . . O .
+    )");
+    fork.forceSide(Player::Black);
+
+    ThreatSearch solver;
+    const auto vcf = solver.solve(fork, rules, ThreatSearch::Mode::VCF);
+    ASSERT_TRUE(vcf.win);
+    ASSERT_TRUE(vcf.line.size() % 2 == 1);
+    ASSERT_TRUE(vcf.line.front().pos == (Pos { 8, 5 }));
+    ASSERT_TRUE(vcf.nodes > 0);
+    // La suite se rejoue légalement jusqu'à la victoire de l'attaquant
+    {
+        Board replay = fork;
+        for (const Move& m : vcf.line)
+            ASSERT_TRUE(replay.tryPlay(m, rules));
+        ASSERT_TRUE(replay.status() == GameStatus::WinByAlign);
+    }
+    ASSERT_TRUE(fork.isEmpty(8, 5)); // plateau restauré
+
+    // Même motif, colonne pleine : la paire diagonale (7,5)-(8,6) devient capturable
+    // depuis (6,4), le quatre n'est plus gagnant
+    Board refuted;
+    test_utils::set_board(refuted, R"(
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . O X X X . .
+        . . . . . . . . X .
+        . . . . . . . . X .
+        . . . . . . . . X .
+        . . . . . . . . O .
+    )");
+    refuted.forceSide(Player::Black);
+    ThreatSearch capAware;
+    ASSERT_FALSE(capAware.solve(refuted, rules, ThreatSearch::Mode::VCF).win);
+
+    // Ouverture calme : ni VCF ni VCT
+    Board quiet;
+    quiet.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    quiet.tryPlay(Move { { 9, 10 }, Player::White }, rules);
+    quiet.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+    ThreatSearch calm;
+    ASSERT_FALSE(calm.solve(quiet, rules, ThreatSearch::Mode::VCF).win);
+    ASSERT_FALSE(calm.solve(quiet, rules, ThreatSearch::Mode::VCT).win);
+
+    // Limite de nœuds : abandon sans victoire annoncée
+    ThreatSearchConfig tiny;
+    tiny.nodeLimit = 1;
+    ThreatSearch starved(tiny);
+    ASSERT_FALSE(starved.solve(fork, rules, ThreatSearch::Mode::VCF).win);
+
+    // Intégration : la racine joue le coup du VCF sans lancer l'alpha-bêta
+    SearchConfig cfg;
+    cfg.timeBudgetMs = 500;
+    cfg.ttBytes = 16ull << 20;
+    MinimaxSearch search(cfg);
+    SearchStats stats;
+    const auto move = search.bestMove(fork, rules, &stats);
+    printSearchStats(stats, "VCF à la racine");
+    ASSERT_TRUE(move.has_value());
+    ASSERT_TRUE(move->pos == (Pos { 8, 5 }));
+    ASSERT_TRUE(stats.threatNodes > 0);
+    ASSERT_EQ(stats.nodes, 0);
+
+    // VCT sans VCF : pas de raccourci, l'alpha-bêta vérifie la suite (son 1er coup en tête)
+    Board threes;
+    test_utils::set_board(threes, R"(
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . X . . . . . .
+        . . . . . . . X . . . . .
+        . . . . . . . . . . . O .
+        . . . . . . . O . . . O .
+        . . . . . . . . . O X . .
+        . . . . . . X . . . . . .
+        . . . . . . . . . . X . O
+    )");
+    threes.forceSide(Player::Black);
+    ThreatSearch vctSolver;
+    ASSERT_FALSE(vctSolver.solve(threes, rules, ThreatSearch::Mode::VCF).win);
+    const auto vct = vctSolver.solve(threes, rules, ThreatSearch::Mode::VCT);
+    ASSERT_TRUE(vct.win);
+    MinimaxSearch checked(cfg);
+    SearchStats vctStats;
+    const auto vctMove = checked.bestMove(threes, rules, &vctStats);
+    printSearchStats(vctStats, "VCT vérifié");
+    ASSERT_TRUE(vctMove.has_value());
+    ASSERT_TRUE(vctStats.threatNodes > 0);
+    ASSERT_TRUE(vctStats.nodes > 0);
+    ASSERT_TRUE(vctStats.depthReached >= 2);
+
+    TEST_PASSED();
+}
+
+// Test 18: df-pn - victoire et défaite prouvées, gain par captures, table bornée
+TEST(ai_proof_number_search)
+{
+    std::cout << "\n=== Test: solveur df-pn ===" << std::endl;
+
+    RuleSet rules {};
+    const char* forkPattern = R"(
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . O X X X . .
+        . . . . . . . . . .
+        . . . . . . . . X .
+        . . . . . . . . X .
+        . . . . . . . . X .
+        . . . . . . . . O .
+    )";
+    auto replayWins = [](const Board& from, const std::vector<Move>& line, const RuleSet& r) {
+        Board b = from;
+        for (const Move& m : line)
+            if (!b.tryPlay(m, r))
+                return false;
+        return b.status() == GameStatus::WinByAlign || b.status() == GameStatus::WinByCapture;
+    };
+
+    // Victoire au trait : double quatre
+    Board fork;
+    test_utils::set_board(fork, forkPattern);
+    fork.forceSide(Player::Black);
+    ProofNumberSearch solver;
+    const ProofResult win = solver.solve(fork, rules);
+    std::cout << "  fork: " << win.nodes << " nœuds, " << win.line.size() << " coups" << std::endl;
+    ASSERT_TRUE(win.value == ProofValue::Win);
+    ASSERT_TRUE(win.line.front().pos == (Pos { 8, 5 }));
+    ASSERT_TRUE(win.line.size() % 2 == 1);
+    ASSERT_TRUE(replayWins(fork, win.line, rules));
+
+    // Défaite au trait : quatre ouvert adverse
+    Board openFour;
+    test_utils::set_board(openFour, R"(
+        . . . . . . . . . .
+        . . . . . . . . . .
+        . . . . X X X X . .
+        . . . . . . . . . .
+        . . O . . . . . . .
+        . . . . . . O . . .
+    )", 3, 3);
+    openFour.forceSide(Player::White);
+    const ProofResult loss = solver.solve(openFour, rules);
+    ASSERT_TRUE(loss.value == ProofValue::Loss);
+    ASSERT_EQ(static_cast<int>(loss.line.size()), 2);
+    ASSERT_TRUE(loss.line.front().by == Player::White);
+    ASSERT_TRUE(replayWins(openFour, loss.line, rules));
+
+    // Gain par captures (captureWinPairs = 1) : X O O _
+    RuleSet oneCapture {};
+    oneCapture.captureWinPairs = 1;
+    Board capture;
+    test_utils::set_board(capture, R"(
+        . . . . . .
+        . X O O . .
+        . . . . . .
+    )", 7, 7);
+    capture.forceSide(Player::Black);
+    const ProofResult byCapture = solver.solve(capture, oneCapture);
+    ASSERT_TRUE(byCapture.value == ProofValue::Win);
+    ASSERT_EQ(static_cast<int>(byCapture.line.size()), 1);
+    ASSERT_TRUE(byCapture.line.front().pos == (Pos { 11, 8 }));
+
+    // Table minuscule : preuve conservée malgré les évictions
+    ProofSearchConfig small;
+    small.tableBytes = 4096;
+    ProofNumberSearch cramped(small);
+    const ProofResult tight = cramped.solve(fork, rules);
+    ASSERT_TRUE(cramped.tableEntries() * 24 <= 4096);
+    ASSERT_TRUE(tight.value == ProofValue::Win);
+    ASSERT_TRUE(replayWins(fork, tight.line, rules));
+
+    // Position calme : rien de prouvé dans le budget, limite respectée
+    Board quiet;
+    quiet.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    quiet.tryPlay(Move { { 9, 10 }, Player::White }, rules);
+    quiet.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+    ISolver& iface = solver;
+    iface.setNodeLimit(2'000);
+    const ProofResult unknown = iface.solve(quiet, rules);
+    ASSERT_TRUE(unknown.value == ProofValue::Unknown);
+    ASSERT_TRUE(unknown.line.empty());
+    ASSERT_TRUE(unknown.nodes <= 2'001);
+    ASSERT_EQ(quiet.moveCount(), 3);
+
+    TEST_PASSED();
+}
+
+// Test 19: Course aux captures - verdict exact, cache, oracle de negamax
+TEST(ai_capture_race_oracle)
+{
+    std::cout << "\n=== Test: course aux captures ===" << std::endl;
+
+    RuleSet rules {};
+    rules.captureWinPairs = 2;
+
+    // Deux paires blanches ouvertes qu'une pierre en (5,5) menace à la fois
+    Board board;
+    test_utils::set_board(board, R"(
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . O O . . . . .
+        . . . . . O . . . . . . .
+        . . . . . O . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . . . .
+        . . . . . . . . . . X O O
+    )");
+    board.forceSide(Player::Black);
+
+    CaptureRace race;
+    ASSERT_FALSE(race.applies(board, rules)); // aucune paire prise
+    ASSERT_TRUE(board.tryPlay(Move { { 13, 10 }, Player::Black }, rules)); // 1re paire
+    ASSERT_TRUE(board.tryPlay(Move { { 15, 15 }, Player::White }, rules));
+    ASSERT_TRUE(race.applies(board, rules));
+
+    const auto win = race.decide(board, rules);
+    ASSERT_TRUE(win.verdict == CaptureRace::Verdict::Win);
+    ASSERT_EQ(win.plies, 3); // double menace, parade, capture
+    ASSERT_EQ(board.moveCount(), 2); // plateau restauré
+
+    // Verdict en cache : aucun nœud de plus
+    const long long nodes = race.nodes();
+    ASSERT_TRUE(race.decide(board, rules).verdict == CaptureRace::Verdict::Win);
+    ASSERT_EQ(race.nodes(), nodes);
+
+    // Après la double menace, Blanc est perdu ; après un coup lointain, rien de forcé
+    Board threatened = board;
+    ASSERT_TRUE(threatened.tryPlay(Move { { 5, 5 }, Player::Black }, rules));
+    const auto loss = race.decide(threatened, rules);
+    ASSERT_TRUE(loss.verdict == CaptureRace::Verdict::Loss);
+    ASSERT_EQ(loss.plies, 2);
+
+    Board quiet = board;
+    ASSERT_TRUE(quiet.tryPlay(Move { { 0, 18 }, Player::Black }, rules));
+    ASSERT_TRUE(race.decide(quiet, rules).verdict == CaptureRace::Verdict::Unknown);
+
+    // Oracle dans negamax : le coup gagnant est trouvé par le verdict de la course
+    SearchConfig cfg;
+    cfg.timeBudgetMs = 300;
+    cfg.ttBytes = 16ull << 20;
+    cfg.useThreatSearch = false;
+    cfg.captureRaceMinDepth = 1; // consulté dès les fils de la racine
+    MinimaxSearch search(cfg);
+    SearchStats stats;
+    const auto move = search.bestMove(board, rules, &stats);
+    printSearchStats(stats, "oracle de course aux captures");
+    ASSERT_TRUE(move.has_value());
+    ASSERT_TRUE(move->pos == (Pos { 5, 5 }));
+    ASSERT_TRUE(stats.raceProofs > 0);
+    ASSERT_TRUE(stats.raceNodes > 0);
+
+    cfg.useCaptureRace = false;
+    MinimaxSearch plain(cfg);
+    SearchStats plainStats;
+    ASSERT_TRUE(plain.bestMove(board, rules, &plainStats).has_value());
+    ASSERT_EQ(plainStats.raceNodes, 0);
+
+    TEST_PASSED();
+}
+
 // ============================================================================
+// Test 20: MCTS (PUCT) - parade forcée, gain immédiat, budget de playouts, threads, arène pleine
+TEST(ai_mcts_engine)
+{
+    std::cout << "\n=== Test: moteur MCTS ===" << std::endl;
+
+    RuleSet rules {};
+    // Quatre noir fermé à gauche : Blanc doit jouer (11,9)
+    Board board;
+    board.tryPlay(Move { { 7, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 6, 9 }, Player::White }, rules);
+    board.tryPlay(Move { { 8, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 7, 8 }, Player::White }, rules);
+    board.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    board.tryPlay(Move { { 8, 8 }, Player::White }, rules);
+    board.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+
+    MctsConfig cfg;
+    cfg.arenaBytes = 8ull << 20;
+    cfg.timeBudgetMs = 200;
+    MctsSearch mcts(cfg);
+    SearchStats stats;
+    auto move = mcts.bestMove(board, rules, &stats);
+    printSearchStats(stats, "MCTS parade");
+    ASSERT_TRUE(move.has_value());
+    ASSERT_TRUE(move->pos == (Pos { 11, 9 }));
+    ASSERT_TRUE(stats.nodes > 0);
+    ASSERT_TRUE(!stats.principalVariation.empty());
+    ASSERT_TRUE(mcts.treeSize() > 1 && mcts.treeSize() <= mcts.arenaCapacity());
+
+    // Blanc ne bloque pas : Noir gagne sans chercher
+    Board win = board;
+    ASSERT_TRUE(win.tryPlay(Move { { 0, 0 }, Player::White }, rules).success);
+    move = mcts.bestMove(win, rules, &stats);
+    ASSERT_TRUE(move.has_value());
+    ASSERT_TRUE(move->pos == (Pos { 11, 9 }));
+    ASSERT_EQ(stats.depthReached, 1);
+
+    // Budget de playouts : exact et reproductible sur un thread, horloge ignorée
+    Board open;
+    open.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    open.tryPlay(Move { { 9, 10 }, Player::White }, rules);
+    open.tryPlay(Move { { 10, 9 }, Player::Black }, rules);
+    cfg.timeBudgetMs = 1;
+    cfg.playoutBudget = 3'000;
+    MctsSearch first(cfg), second(cfg);
+    SearchStats a, b;
+    const auto moveA = first.bestMove(open, rules, &a);
+    const auto moveB = second.bestMove(open, rules, &b);
+    printSearchStats(a, "MCTS 3000 playouts");
+    ASSERT_TRUE(moveA.has_value() && moveB.has_value());
+    ASSERT_EQ(a.nodes, 3'000);
+    ASSERT_TRUE(*moveA == *moveB);
+    ASSERT_TRUE(a.principalVariation == b.principalVariation);
+
+    // stop() avant bestMove() : cette recherche s'arrête d'emblée, la suivante va au budget
+    MctsSearch early(cfg);
+    early.stop();
+    SearchStats e;
+    early.bestMove(open, rules, &e);
+    ASSERT_EQ(e.nodes, 0);
+    ASSERT_TRUE(early.bestMove(open, rules, &e).has_value());
+    ASSERT_EQ(e.nodes, 3'000);
+
+    // Réflexion puis ponder hit, temps adaptatif : la racine n'est suivie qu'à partir du hit,
+    // toutes les optimumMs / 8 (pas de stabilité accumulée pendant la réflexion). L'arrêt le
+    // plus tôt demande 3 contrôles stables après le 1er : 3 × 125 ms
+    MctsConfig ponderCfg = cfg;
+    ponderCfg.playoutBudget = 0;
+    ponderCfg.adaptiveTime = true;
+    MctsSearch pondering(ponderCfg);
+    pondering.startPonder(open, rules);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const auto hitAt = std::chrono::steady_clock::now();
+    SearchStats h;
+    ASSERT_TRUE(pondering.ponderHit(2000, &h).has_value()); // optimum 1000 ms, hard 2000 ms
+    const auto afterHit = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - hitAt).count();
+    std::cout << "    MCTS ponder hit: " << afterHit << " ms après le hit" << std::endl;
+    ASSERT_TRUE(afterHit >= 350 && afterHit < 2200);
+
+    // Parallélisme d'arbre : le budget couvre tous les threads
+    cfg.threads = 4;
+    MctsSearch parallel(cfg);
+    SearchStats p;
+    const auto moveP = parallel.bestMove(open, rules, &p);
+    ASSERT_TRUE(moveP.has_value());
+    ASSERT_TRUE(p.nodes > 0 && p.nodes <= 3'000);
+    ASSERT_TRUE(open.isEmpty(moveP->pos.x, moveP->pos.y));
+
+    // Arène pleine : les feuilles sont évaluées sans développement, la recherche continue
+    cfg.threads = 1;
+    cfg.arenaBytes = 2'000;
+    MctsSearch small(cfg);
+    SearchStats s;
+    ASSERT_TRUE(small.bestMove(open, rules, &s).has_value());
+    ASSERT_EQ(s.nodes, 3'000);
+    ASSERT_TRUE(small.treeSize() <= small.arenaCapacity());
+
+    // Choisi via GameService::setSearchEngine, comme MinimaxSearchEngine
+    application::GameService game;
+    game.startNewGame(rules);
+    game.setSearchEngine(std::make_unique<MctsSearchEngine>());
+    ASSERT_TRUE(game.makeMove(Move { { 9, 9 }, Player::Black }).success);
+    SearchStats gs;
+    const auto reply = game.getAIMove(100, &gs);
+    ASSERT_TRUE(reply.has_value());
+    ASSERT_TRUE(reply->by == Player::White);
+    ASSERT_TRUE(game.makeMove(*reply).success);
+    ASSERT_TRUE(gs.timeMs < 300);
+
+    TEST_PASSED();
+}
+
+// Test 21: NNUE - fichier de poids, accumulateurs incrémentaux (captures comprises), sélection par EvalConfig
+TEST(ai_nnue_evaluator)
+{
+    std::cout << "\n=== Test: évaluateur NNUE ===" << std::endl;
+    using namespace std::chrono;
+    using eval::NnueNetwork;
+    using eval::NnueWeights;
+
+    // Réseau pseudo-aléatoire : les valeurs n'ont pas de sens, seule la cohérence compte
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    auto next = [&seed](int span) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<int>((seed >> 33) % static_cast<uint64_t>(2 * span + 1)) - span;
+    };
+    NnueWeights w = NnueWeights::zero();
+    for (auto& v : w.featureWeights)
+        v = static_cast<int16_t>(next(48));
+    for (auto& v : w.featureBias)
+        v = static_cast<int16_t>(next(32));
+    for (auto& v : w.outputWeights)
+        v = static_cast<int8_t>(next(64));
+    w.outputBias = 250;
+    w.outputScale = 3 << 16;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "gomoku_nnue_test.bin").string();
+    ASSERT_TRUE(w.save(path));
+    const auto loaded = NnueWeights::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_TRUE(loaded->featureWeights == w.featureWeights && loaded->outputWeights == w.outputWeights);
+    ASSERT_EQ(loaded->outputScale, w.outputScale);
+    const auto net = NnueNetwork::open(path);
+    ASSERT_TRUE(net != nullptr);
+    ASSERT_TRUE(NnueNetwork::open(path) == net); // lu une seule fois
+    std::cout << "  Noyaux: " << NnueNetwork::simdName() << std::endl;
+
+    // Fichier tronqué ou absent : refusé
+    const std::string truncated = path + ".short";
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(truncated, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    }
+    ASSERT_FALSE(NnueWeights::load(truncated).has_value());
+    ASSERT_TRUE(NnueNetwork::open(truncated) == nullptr);
+    std::remove(truncated.c_str());
+
+    // Partie aléatoire serrée (captures fréquentes) avec retours arrière : incrémental == recalcul
+    RuleSet rules {};
+    Board board;
+    Board other;
+    other.tryPlay(Move { { 3, 3 }, Player::Black }, rules);
+    int checked = 0;
+    int mismatches = 0;
+    auto check = [&](const Board& b) {
+        for (const Player p : { Player::Black, Player::White }) {
+            mismatches += net->evaluate(b, p) != net->evaluateFull(b, p);
+            ++checked;
+        }
+    };
+    for (int ply = 0; ply < 400 && board.status() == GameStatus::Ongoing; ++ply) {
+        const int r = next(100);
+        if (r < -60 && board.historySize() > 0) {
+            board.unmakeMove();
+        } else {
+            for (int attempt = 0; attempt < 50; ++attempt) {
+                const Pos p { static_cast<uint8_t>(7 + next(3)), static_cast<uint8_t>(7 + next(3)) };
+                if (board.makeMove(Move { p, board.toPlay() }, rules))
+                    break;
+            }
+        }
+        check(board);
+        if (r > 90)
+            check(other); // autre plateau : l'accumulateur est reconstruit, puis retrouvé
+    }
+    const auto caps = board.capturedPairs();
+    std::cout << "  Positions: " << checked << ", paires capturées: " << caps.black << "/" << caps.white << std::endl;
+    ASSERT_EQ(mismatches, 0);
+    ASSERT_TRUE(caps.black + caps.white > 0);
+
+    // Sélection par EvalConfig ; fichier illisible : évaluation classique
+    eval::EvalConfig ec;
+    ec.useNnue = true;
+    ec.nnueFile = path;
+    const eval::Evaluator nnueEval(ec);
+    ASSERT_TRUE(nnueEval.usesNnue());
+    ASSERT_EQ(nnueEval.evaluate(board, Player::White), net->evaluateFull(board, Player::White));
+    eval::EvalConfig missing = ec;
+    missing.nnueFile = path + ".absent";
+    const eval::Evaluator fallback(missing);
+    ASSERT_FALSE(fallback.usesNnue());
+    ASSERT_EQ(fallback.evaluate(board, Player::White), eval::Evaluator {}.evaluate(board, Player::White));
+
+    // Coût par nœud : coup, évaluation, retour arrière sur les candidats d'une position de milieu de partie
+    while (board.status() != GameStatus::Ongoing)
+        board.unmakeMove();
+    const auto cands = CandidateGenerator::generate(board, rules, board.toPlay(), CandidateConfig {});
+    auto bench = [&](const eval::Evaluator& e) {
+        long long sink = 0;
+        int evals = 0;
+        const auto t0 = steady_clock::now();
+        for (int rep = 0; rep < 200; ++rep)
+            for (const Move& m : cands)
+                if (board.makeMove(m, rules)) {
+                    sink += e.evaluate(board, m.by);
+                    ++evals;
+                    board.unmakeMove();
+                }
+        const auto ns = duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+        return std::make_pair(evals > 0 ? ns / evals : 0, sink);
+    };
+    const auto classic = bench(eval::Evaluator {});
+    const auto quantized = bench(nnueEval);
+    std::cout << "  ns/évaluation: classique " << classic.first << ", NNUE " << quantized.first << std::endl;
+
+    // MinimaxSearch et son moteur avec le réseau, helpers Lazy SMP compris
+    SearchConfig cfg;
+    cfg.ttBytes = 16ull << 20;
+    cfg.nodeBudget = 20'000;
+    cfg.threads = 2;
+    Board start;
+    start.tryPlay(Move { { 9, 9 }, Player::Black }, rules);
+    start.tryPlay(Move { { 9, 10 }, Player::White }, rules);
+    MinimaxSearch search(cfg, ec);
+    SearchStats stats;
+    const auto move = search.bestMove(start, rules, &stats);
+    ASSERT_TRUE(move.has_value());
+    ASSERT_EQ(search.evaluatePublic(start, Player::Black), net->evaluateFull(start, Player::Black));
+    MinimaxSearchEngine engine(cfg, ec);
+    ASSERT_TRUE(engine.findBestMove(start, rules).has_value());
+
+    std::remove(path.c_str());
+    TEST_PASSED();
+}
+
+// Test 22: mémoire de la TT - dimensionner ne la faulte pas, prefault() le fait une fois
+// (pages résidentes lues dans /proc/self/statm)
+static long long residentBytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    long long pages = 0, resident = -1;
+    if (!(statm >> pages >> resident))
+        return -1;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+TEST(ai_tt_lazy_mapping)
+{
+    std::cout << "\n=== Test: TT faultée à la demande ===" << std::endl;
+    constexpr std::size_t SIZE = 128ull << 20;
+    const bool statm = residentBytes() >= 0;
+
+    // Huit tables privées de 128 MB : rien de résident tant qu'aucune recherche n'y écrit
+    // (les pages hugetlb, réservées, sont les seules faultées au dimensionnement)
+    std::vector<std::unique_ptr<TranspositionTable>> tables;
+    const long long before = residentBytes();
+    std::size_t eager = 0;
+    for (int i = 0; i < 8; ++i) {
+        tables.emplace_back(new TranspositionTable);
+        tables.back()->resizeBytes(SIZE);
+        ASSERT_EQ(tables.back()->bytes(), SIZE);
+        if (tables.back()->faultedIn()) {
+            ASSERT_TRUE(tables.back()->hugePages());
+            ++eager;
+        }
+    }
+    if (statm && eager == 0)
+        ASSERT_TRUE(residentBytes() - before < static_cast<long long>(SIZE / 4));
+
+    // prefault() : toutes les pages d'un coup, entrées conservées, une seule fois
+    TranspositionTable& tt = *tables.front();
+    const uint64_t key = 0x123456789ABCDEFull;
+    tt.store(key, 7, 42, TranspositionTable::Flag::Exact, Move { { 3, 4 }, Player::Black });
+    const bool wasLazy = !tt.faultedIn();
+    const long long beforeFault = residentBytes();
+    tt.prefault();
+    ASSERT_TRUE(tt.faultedIn());
+    if (statm && wasLazy)
+        ASSERT_TRUE(residentBytes() - beforeFault > static_cast<long long>(SIZE / 2));
+    TranspositionTable::Entry e;
+    ASSERT_TRUE(tt.probe(key, e));
+    ASSERT_EQ(e.score, 42);
+    ASSERT_EQ(e.depth, 7);
+    tt.resizeBytes(SIZE); // même taille : clear(), la table reste faultée
+    ASSERT_TRUE(tt.faultedIn());
+    tt.resizeBytes(SIZE / 2); // nouvelle table : de nouveau à la demande
+    if (eager == 0)
+        ASSERT_FALSE(tt.faultedIn());
+    tables.clear();
+
+    // La table partagée du pool sert toutes les sessions : faultée à sa création
+    ttpool::setBudgetBytes(4ull << 20);
+    {
+        const auto shared = ttpool::acquire();
+        ASSERT_TRUE(shared->faultedIn());
+    }
+    ttpool::setBudgetBytes(ttpool::DEFAULT_BUDGET_BYTES);
+
+    TEST_PASSED();
+}
+
 // Test entry point
 // ============================================================================
 
@@ -12,6 +12,8 @@ extern void run_all_capture_tests();
 extern void run_all_double_three_tests();
 extern void run_all_legality_tests();
 extern void run_all_reversibility_tests();
+extern void run_all_bitboard_tests();
+extern void run_all_board_size15_tests();
 
 int main(int argc, char** argv)
 {
@@ -44,6 +46,8 @@ int main(int argc, char** argv)
     run_all_double_three_tests();
     run_all_legality_tests();
     run_all_reversibility_tests();
+    run_all_bitboard_tests();
+    run_all_board_size15_tests();
 
     return 0;
 }
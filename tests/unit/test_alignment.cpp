@@ -2,6 +2,7 @@
 #include "../utils/BoardBuilder.hpp"
 #include "../utils/BoardPrinter.hpp"
 #include "gomoku/core/Board.hpp"
+#include "gomoku/core/PatternAnalyzer.hpp"
 #include "gomoku/core/Types.hpp"
 #include "../framework/test_framework.hpp"
 #include <iostream>
@@ -300,6 +301,37 @@ TEST(detect_all_four_directions)
     TEST_PASSED();
 }
 
+// Test 2.12: Five tracking follows captures and undo; only a breaking capture is legal
+TEST(five_tracking_follows_captures)
+{
+    Board board;
+    RuleSet rules;
+    rules.capturesEnabled = true;
+    rules.allowFiveOrMore = true;
+
+    test_utils::set_horizontal(board, "OOOOO", 5, 6); // (5,6) .. (9,6)
+    test_utils::set_vertical(board, "OX", 6, 7); // (6,7) O, (6,8) X
+    board.forceSide(Player::Black);
+
+    const BoardState& st = board.rawState();
+    ASSERT_TRUE(pattern::hasAnyFive(st, Cell::White));
+    ASSERT_FALSE(pattern::hasAnyFive(st, Cell::Black));
+    ASSERT_EQ(st.fiveLines(Cell::White, 0), 1ull << 6);
+
+    // Quiet move is refused: the five must be broken
+    ASSERT_FALSE(board.tryPlay(Move { Pos { 0, 0 }, Player::Black }, rules).success);
+
+    // (6,5) captures (6,6)-(6,7) and breaks the line
+    ASSERT_TRUE(board.tryPlay(Move { Pos { 6, 5 }, Player::Black }, rules).success);
+    ASSERT_FALSE(pattern::hasAnyFive(st, Cell::White));
+    ASSERT_EQ(st.fiveLines(Cell::White, 0), 0ull);
+
+    board.undo();
+    ASSERT_TRUE(pattern::hasAnyFive(st, Cell::White));
+
+    TEST_PASSED();
+}
+
 // ============================================================================
 // Test entry point
 // ============================================================================
@@ -0,0 +1,181 @@
+// Unit tests for the bitboard views kept in sync by BoardState
+#include "../utils/BoardBuilder.hpp"
+#include "gomoku/core/Board.hpp"
+#include "gomoku/core/BoardState.hpp"
+#include "gomoku/core/LineShapes.hpp"
+#include "gomoku/core/PatternAnalyzer.hpp"
+#include "gomoku/core/RayTables.hpp"
+#include "gomoku/core/Types.hpp"
+#include "../framework/test_framework.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace gomoku;
+using namespace test_framework;
+
+// Forward declaration
+void run_all_bitboard_tests();
+
+namespace {
+
+// Rebuilds every bitboard view from the cell array and compares with the incremental one
+bool bitboardsMatchCells(const BoardState& st)
+{
+    for (int i = 0; i < BoardState::N; ++i) {
+        const Pos p = Pos::fromIndex(static_cast<uint16_t>(i));
+        const Cell c = st.getCell(p);
+        for (int d = 0; d < lines::DIRS; ++d)
+            if (st.lineWindow(d, p, 0) != shapes::code(c))
+                return false;
+        for (Cell color : { Cell::Black, Cell::White }) {
+            const bool expected = (c == color);
+            if (st.stones(color).test(i) != expected)
+                return false;
+            for (int d = 0; d < lines::DIRS; ++d) {
+                const lines::Coord lc = lines::coords[d][i];
+                if (lines::test(st.lineBits(color, d, lc.line), lc.bit) != expected)
+                    return false;
+            }
+        }
+    }
+    return st.stones(Cell::Black).count() == st.blackStones
+        && st.stones(Cell::White).count() == st.whiteStones;
+}
+
+} // namespace
+
+// ============================================================================
+// Tests 8) Bitboard views
+// ============================================================================
+
+// Test 8.1: Line geometry - stepping along a direction increments the bit on the same line
+TEST(line_coords_follow_directions)
+{
+    constexpr int DX[4] = { 1, 0, 1, 1 };
+    constexpr int DY[4] = { 0, 1, 1, -1 };
+    for (int d = 0; d < 4; ++d) {
+        for (int y = 0; y < BOARD_SIZE; ++y) {
+            for (int x = 0; x < BOARD_SIZE; ++x) {
+                const int nx = x + DX[d], ny = y + DY[d];
+                if (nx < 0 || ny < 0 || nx >= BOARD_SIZE || ny >= BOARD_SIZE)
+                    continue;
+                const auto a = lines::coords[d][y * BOARD_SIZE + x];
+                const auto b = lines::coords[d][ny * BOARD_SIZE + nx];
+                ASSERT_EQ(a.line, b.line);
+                ASSERT_EQ(a.bit + 1, b.bit);
+                ASSERT_TRUE(lines::test(lines::valid[d][a.line], a.bit));
+            }
+        }
+    }
+
+    TEST_PASSED();
+}
+
+// Test 8.2: Masks follow placements, captures and undo
+TEST(bitboards_follow_captures_and_undo)
+{
+    Board board;
+    RuleSet rules;
+
+    test_utils::set_horizontal(board, "XOO", 5, 5);
+    test_utils::set_vertical(board, "XOO", 8, 2);
+    ASSERT_TRUE(bitboardsMatchCells(board.rawState()));
+
+    board.forceSide(Player::Black);
+    ASSERT_TRUE(board.tryPlay(Move { Pos { 8, 5 }, Player::Black }, rules).success);
+    ASSERT_EQ(board.capturedPairs().black, 2);
+    ASSERT_TRUE(bitboardsMatchCells(board.rawState()));
+    ASSERT_FALSE(board.rawState().stones(Cell::White).any());
+
+    board.undo();
+    ASSERT_TRUE(bitboardsMatchCells(board.rawState()));
+    ASSERT_EQ(board.rawState().stones(Cell::White).count(), 4);
+
+    TEST_PASSED();
+}
+
+// Test 8.3: Line words expose runs on every direction, including board edges
+TEST(line_words_expose_runs)
+{
+    Board board;
+    test_utils::set_diagonal_asc(board, "XXXXX", 0, 4); // (0,4) .. (4,0)
+
+    const BoardState& st = board.rawState();
+    const Pos start { 0, 4 };
+    const uint32_t anti = st.lineBits(Cell::Black, 3, start);
+    ASSERT_EQ(anti, 0x1Fu);
+    ASSERT_EQ(lines::runUp(anti, lines::coords[3][start.toIndex()].bit), 5);
+    ASSERT_EQ(st.lineEmpty(3, lines::coords[3][start.toIndex()].line), 0u);
+
+    TEST_PASSED();
+}
+
+// Test 8.4: Line codes - walls past the edge and shape lookups through a cell
+TEST(line_codes_classify_shapes)
+{
+    Board board;
+    test_utils::set_horizontal(board, "XXX", 0, 0); // (0,0) .. (2,0)
+    test_utils::set_horizontal(board, "OO", 7, 3); // (7,3) (8,3)
+    test_utils::set_horizontal(board, "O", 10, 3);
+
+    const BoardState& st = board.rawState();
+    ASSERT_TRUE(bitboardsMatchCells(st));
+
+    // (0,0) row window radius 2: two walls, then X X X
+    const uint32_t w = st.lineWindow(0, Pos { 0, 0 }, 2);
+    ASSERT_EQ(shapes::cellAt(w, 0), shapes::WALL);
+    ASSERT_EQ(shapes::cellAt(w, 1), shapes::WALL);
+    ASSERT_EQ(shapes::cellAt(w, 2), shapes::OWN);
+    ASSERT_EQ(shapes::cellAt(shapes::relative(w, Cell::White), 0), shapes::WALL);
+    ASSERT_EQ(shapes::cellAt(shapes::relative(w, Cell::White), 2), shapes::OTHER);
+
+    // Black on (3,0): closed four against the wall, never open
+    const uint8_t edge = pattern::shapesThrough(st, Pos { 3, 0 }, 0, Cell::Black);
+    ASSERT_TRUE(edge & shapes::FOUR);
+    ASSERT_FALSE(edge & shapes::OPEN_FOUR);
+    ASSERT_FALSE(pattern::shapesThrough(st, Pos { 3, 0 }, 1, Cell::Black));
+
+    // White on (9,3): _OO.O_ -> broken open three, and a four through the gap
+    const uint8_t broken = pattern::shapesThrough(st, Pos { 9, 3 }, 0, Cell::White);
+    ASSERT_TRUE(broken & shapes::FOUR);
+    ASSERT_TRUE(broken & shapes::OPEN_FOUR);
+    ASSERT_FALSE(broken & shapes::FIVE);
+    const uint8_t three = pattern::shapesThrough(st, Pos { 6, 3 }, 0, Cell::White);
+    ASSERT_TRUE(three & shapes::OPEN_THREE);
+    ASSERT_FALSE(three & shapes::OPEN_FOUR);
+
+    TEST_PASSED();
+}
+
+// Test 8.5: Neighbourhood tables agree with line coordinates and stop at the edge
+TEST(line_neighbours_match_coords)
+{
+    for (int d = 0; d < 4; ++d) {
+        for (int i = 0; i < BoardState::N; ++i) {
+            const auto& nb = rays::lineNbrByDir[d][i];
+            const lines::Coord lc = lines::coords[d][i];
+            for (int k = 0; k < rays::NBR_RADIUS; ++k) {
+                ASSERT_EQ(nb.fwd[k] != rays::NONE, k < nb.fwdLen);
+                ASSERT_EQ(nb.bwd[k] != rays::NONE, k < nb.bwdLen);
+                if (k < nb.fwdLen) {
+                    ASSERT_EQ(lines::coords[d][nb.fwd[k]].line, lc.line);
+                    ASSERT_EQ(lines::coords[d][nb.fwd[k]].bit, lc.bit + k + 1);
+                }
+                if (k < nb.bwdLen)
+                    ASSERT_EQ(lines::coords[d][nb.bwd[k]].bit + k + 1, lc.bit);
+            }
+            ASSERT_EQ(nb.fwdLen, std::min(rays::NBR_RADIUS, lines::runUp(lines::valid[d][lc.line], lc.bit) - 1));
+        }
+    }
+
+    TEST_PASSED();
+}
+
+// ============================================================================
+// Test entry point
+// ============================================================================
+
+void run_all_bitboard_tests()
+{
+    run_all_tests("Bitboard Views");
+}
@@ -347,6 +347,29 @@ TEST(board_occupancy_tracking)
     TEST_PASSED();
 }
 
+// Test 1.9: Padded storage - walls around the board, slots map back to dense indexes
+TEST(padded_storage_walls)
+{
+    Board board;
+    board.setStone(Pos { 0, 0 }, Cell::Black);
+    board.setStone(Pos { 18, 18 }, Cell::White);
+    const BoardState& st = board.rawState();
+
+    for (int d = 0; d < 4; ++d) {
+        for (int k = 1; k <= BoardState::PAD; ++k) {
+            ASSERT_EQ(st.cellAtSlot(BoardState::slot(0, 0) - k * BoardState::SLOT_STEP[d]), Cell::Wall);
+            ASSERT_EQ(st.cellAtSlot(BoardState::slot(18, 18) + k * BoardState::SLOT_STEP[d]), Cell::Wall);
+        }
+    }
+    ASSERT_EQ(st.cellAtSlot(BoardState::slot(0, 0)), Cell::Black);
+    ASSERT_EQ(st.cellAtSlot(BoardState::slot(18, 18)), Cell::White);
+
+    for (uint16_t i = 0; i < BoardState::N; ++i)
+        ASSERT_EQ(BoardState::idxOfSlot(BoardState::slot(Pos::fromIndex(i))), i);
+
+    TEST_PASSED();
+}
+
 // ============================================================================
 // Test entry point
 // ============================================================================
@@ -0,0 +1,93 @@
+// Unit tests for the 15x15 instantiation of libgomoku_logic.a
+// This translation unit is built against gomoku::size15 (the rest of the runner uses size19).
+#define GOMOKU_BOARD_SIZE 15
+
+#include "gomoku/ai/MinimaxSearch.hpp"
+#include "gomoku/core/Bitboard.hpp"
+#include "gomoku/core/Board.hpp"
+#include "gomoku/core/Types.hpp"
+#include "../framework/test_framework.hpp"
+#include <iostream>
+
+using namespace gomoku;
+using namespace test_framework;
+
+// Forward declaration
+void run_all_board_size15_tests();
+
+// ============================================================================
+// Tests 9) 15x15 board instantiation
+// ============================================================================
+
+// Test 9.1: Geometry follows BOARD_SIZE
+TEST(size15_geometry)
+{
+    static_assert(BOARD_SIZE == 15);
+    static_assert(lines::COUNT == 29);
+
+    Board board;
+    RuleSet rules;
+    ASSERT_TRUE(board.isInside(14, 14));
+    ASSERT_FALSE(board.isInside(15, 0));
+    ASSERT_FALSE((Pos { 0, 15 }).isValid());
+    ASSERT_EQ(board.legalMoves(Player::Black, rules).size(), static_cast<std::size_t>(15 * 15));
+    ASSERT_FALSE(board.tryPlay({ { 15, 3 }, Player::Black }, rules).success);
+
+    TEST_PASSED();
+}
+
+// Test 9.2: A five touching the right edge wins; make/unmake restores the hash
+TEST(size15_edge_five_and_unmake)
+{
+    Board board;
+    RuleSet rules;
+    const uint64_t start = board.zobristKey();
+
+    for (uint8_t x = 10; x < 14; ++x) {
+        ASSERT_TRUE(board.tryPlay({ { x, 14 }, Player::Black }, rules).success);
+        ASSERT_TRUE(board.tryPlay({ { x, 0 }, Player::White }, rules).success);
+    }
+    const uint64_t before = board.zobristKey();
+    ASSERT_TRUE(board.makeMove({ { 14, 14 }, Player::Black }, rules));
+    ASSERT_EQ(board.status(), GameStatus::WinByAlign);
+    board.unmakeMove();
+    ASSERT_EQ(board.zobristKey(), before);
+    ASSERT_EQ(board.status(), GameStatus::Ongoing);
+
+    while (board.undo()) { }
+    ASSERT_EQ(board.zobristKey(), start);
+
+    TEST_PASSED();
+}
+
+// Test 9.3: The search runs on the 15x15 board and completes the open four
+TEST(size15_search_completes_four)
+{
+    Board board;
+    RuleSet rules;
+    for (uint8_t y = 3; y < 7; ++y) {
+        ASSERT_TRUE(board.tryPlay({ { 14, y }, Player::Black }, rules).success);
+        ASSERT_TRUE(board.tryPlay({ { 0, static_cast<uint8_t>(y * 2) }, Player::White }, rules).success);
+    }
+
+    SearchConfig cfg;
+    cfg.timeBudgetMs = 200;
+    cfg.maxDepthHint = 3;
+    cfg.ttBytes = 1u << 20;
+    MinimaxSearch search(cfg);
+    const auto best = search.bestMove(board, rules, nullptr);
+    ASSERT_TRUE(best.has_value());
+    ASSERT_EQ(best->pos.x, 14);
+    ASSERT_TRUE(best->pos.y == 2 || best->pos.y == 7);
+
+    TEST_PASSED();
+}
+
+// ============================================================================
+// Test entry point
+// ============================================================================
+
+void run_all_board_size15_tests()
+{
+    run_all_tests("15x15 Board");
+}
@@ -2,6 +2,7 @@
 #include "../utils/BoardBuilder.hpp"
 #include "../utils/BoardPrinter.hpp"
 #include "gomoku/core/Board.hpp"
+#include "gomoku/core/PatternAnalyzer.hpp"
 #include "gomoku/core/Types.hpp"
 #include "../framework/test_framework.hpp"
 #include <iostream>
@@ -387,6 +388,52 @@ TEST(double_three_only_for_black)
     TEST_PASSED();
 }
 
+// Test 4.15: the 3^9 window table agrees with the pattern scan on every window
+// (8 neighbours in {empty, own, opponent}, off-board cells as walls), both colours
+TEST(free_three_table_matches_pattern_scan)
+{
+    constexpr int DX[4] = { 1, 0, 1, 1 };
+    constexpr int DY[4] = { 0, 1, 1, -1 };
+    const Pos centres[] = { Pos { 9, 9 }, Pos { 0, 0 }, Pos { 1, 7 }, Pos { 3, BOARD_SIZE - 2 } };
+    int windows = 0;
+
+    for (const Pos c : centres) {
+        for (int d = 0; d < 4; ++d) {
+            Board board;
+            for (int code = 0; code < 6561; ++code) { // 3^8
+                bool skip = false;
+                int rest = code;
+                for (int k = -4; k <= 4; ++k) {
+                    if (k == 0)
+                        continue;
+                    const int t = rest % 3;
+                    rest /= 3;
+                    const int x = c.x + k * DX[d], y = c.y + k * DY[d];
+                    if (x < 0 || y < 0 || x >= BOARD_SIZE || y >= BOARD_SIZE) {
+                        skip |= t != 0; // un seul codage par case hors plateau
+                        continue;
+                    }
+                    board.setStone(Pos { static_cast<uint8_t>(x), static_cast<uint8_t>(y) },
+                        t == 0 ? Cell::Empty : t == 1 ? Cell::Black : Cell::White);
+                }
+                if (skip)
+                    continue;
+                for (const Player p : { Player::Black, Player::White }) {
+                    const Move m { c, p };
+                    if (pattern::formsFreeThree(board.rawState(), m, d) != pattern::formsFreeThreeScan(board.rawState(), m, d)) {
+                        std::cout << "mismatch at (" << int(c.x) << "," << int(c.y) << ") dir " << d << " code " << code << "\n";
+                        ASSERT_TRUE(false);
+                    }
+                    ++windows;
+                }
+            }
+        }
+    }
+    ASSERT_TRUE(windows > 2 * 6561 * 4);
+
+    TEST_PASSED();
+}
+
 // ============================================================================
 // Entry point for tests
 // ============================================================================
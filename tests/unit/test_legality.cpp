@@ -2,6 +2,7 @@
 #include "../utils/BoardBuilder.hpp"
 #include "../utils/BoardPrinter.hpp"
 #include "gomoku/core/Board.hpp"
+#include "gomoku/core/RulePolicy.hpp"
 #include "gomoku/core/Types.hpp"
 #include "../framework/test_framework.hpp"
 #include <iostream>
@@ -323,6 +324,35 @@ TEST(no_capture_across_board_edge)
     TEST_PASSED();
 }
 
+// Test 5.12: Rule flags select the matching variant (no capture, free double-three)
+TEST(rule_variants_follow_flags)
+{
+    static_assert(rules::policyIndex(RuleSet {}) == 7, "default rules are the standard variant");
+
+    RuleSet freestyle;
+    freestyle.capturesEnabled = false;
+    freestyle.forbidDoubleThree = false;
+
+    // X O O _ : no capture without the capture rule
+    Board board;
+    test_utils::set_horizontal(board, "XOO", 5, 5);
+    board.forceSide(Player::Black);
+    ASSERT_TRUE(board.tryPlay(Move { Pos { 8, 5 }, Player::Black }, freestyle).success);
+    ASSERT_EQ(board.at(6, 5), Cell::White);
+    ASSERT_EQ(board.capturedPairs().black, 0);
+
+    // Double free three: refused by default, allowed in freestyle
+    Board dt;
+    test_utils::set_horizontal(dt, "XX", 8, 9); // (8,9) (9,9)
+    test_utils::set_vertical(dt, "XX", 10, 7); // (10,7) (10,8)
+    dt.forceSide(Player::Black);
+    const Move cross { Pos { 10, 9 }, Player::Black };
+    ASSERT_FALSE(dt.makeMove(cross, RuleSet {}));
+    ASSERT_TRUE(dt.makeMove(cross, freestyle));
+
+    TEST_PASSED();
+}
+
 // ============================================================================
 // Entry point for tests
 // ============================================================================
@@ -3,6 +3,7 @@
 #include "../utils/BoardPrinter.hpp"
 #include "gomoku/core/Board.hpp"
 #include "gomoku/core/Types.hpp"
+#include "gomoku/core/Zobrist.hpp"
 #include "../framework/test_framework.hpp"
 #include <iostream>
 
@@ -443,3 +444,76 @@ TEST(save_load_functionality)
     
     TEST_PASSED();
 }
+
+// Test 7.15: Search make/unmake mirrors tryPlay/undo without touching redo history
+TEST(make_unmake_matches_try_play)
+{
+    Board board;
+    RuleSet rules;
+    rules.capturesEnabled = true;
+
+    test_utils::set_horizontal(board, "XOO", 5, 5);
+    test_utils::set_vertical(board, "XOO", 8, 2);
+    board.forceSide(Player::White);
+    ASSERT_TRUE(board.tryPlay(Move { Pos { 0, 0 }, Player::White }, rules).success);
+    board.undo(); // one move on the redo stack
+
+    board.forceSide(Player::Black);
+    const uint64_t hashBefore = board.zobristKey();
+    const int movesBefore = board.moveCount();
+
+    // Illegal move: rejected without mutation
+    ASSERT_FALSE(board.makeMove(Move { Pos { 5, 5 }, Player::Black }, rules));
+    ASSERT_EQ(board.zobristKey(), hashBefore);
+
+    // Double capture, then unmake
+    ASSERT_TRUE(board.makeMove(Move { Pos { 8, 5 }, Player::Black }, rules));
+    ASSERT_EQ(board.capturedPairs().black, 2);
+    ASSERT_EQ(board.moveCount(), movesBefore + 1);
+    ASSERT_EQ(board.lastMove()->pos, (Pos { 8, 5 }));
+    board.unmakeMove();
+
+    ASSERT_EQ(board.zobristKey(), hashBefore);
+    ASSERT_EQ(board.moveCount(), movesBefore);
+    ASSERT_EQ(board.capturedPairs().black, 0);
+    ASSERT_EQ(board.at(7, 5), Cell::White);
+    ASSERT_EQ(board.at(8, 3), Cell::White);
+    ASSERT_EQ(board.toPlay(), Player::Black);
+    ASSERT_TRUE(board.canRedo());
+
+    TEST_PASSED();
+}
+
+// Test 7.16: Captured pairs and game status are part of the hash
+TEST(hash_includes_pairs_and_status)
+{
+    RuleSet rules;
+    rules.capturesEnabled = true;
+
+    // Same stones and side to move, only the capture counter differs
+    Board a, b;
+    test_utils::set_horizontal(a, "XOO", 5, 5);
+    a.forceSide(Player::Black);
+    ASSERT_TRUE(a.tryPlay(Move { Pos { 8, 5 }, Player::Black }, rules).success);
+    ASSERT_EQ(a.capturedPairs().black, 1);
+
+    test_utils::set_horizontal(b, "X", 5, 5);
+    test_utils::set_horizontal(b, "X", 8, 5);
+    b.forceSide(Player::White);
+    ASSERT_EQ(a.rawState().stones(Cell::Black), b.rawState().stones(Cell::Black));
+    ASSERT_NE(a.zobristKey(), b.zobristKey());
+
+    // Winning move: the key differs from the same stones in an ongoing game
+    Board c;
+    test_utils::set_horizontal(c, "XXXX", 3, 3);
+    c.forceSide(Player::Black);
+    ASSERT_TRUE(c.tryPlay(Move { Pos { 7, 3 }, Player::Black }, rules).success);
+    ASSERT_EQ(c.status(), GameStatus::WinByAlign);
+    Board d;
+    test_utils::set_horizontal(d, "XXXXX", 3, 3);
+    d.forceSide(Player::White);
+    ASSERT_NE(c.zobristKey(), d.zobristKey());
+    ASSERT_EQ(c.zobristKey() ^ zobrist::status(GameStatus::WinByAlign), d.zobristKey());
+
+    TEST_PASSED();
+}